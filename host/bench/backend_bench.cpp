@@ -0,0 +1,93 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Backend benchmark: CPU time per frame of update() on the host, and frames
+// per second with the capture backend simulating wire time. The capture
+// backend must send the same byte stream as the I2S driver stand-ins.
+
+#include <chrono>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+static const int LEDS = 300;
+
+struct Run {
+    std::vector<uint8_t> stream;
+    double cpu_us;      // Mean time per update() call
+    double fps;         // Frames per second over the run
+    uint64_t wire_us;   // Simulated wire time of all frames
+};
+
+/**
+ * @brief Send frames through a backend and time them
+ * @param backend Backend, or NULL for the default I2S driver
+ */
+static Run run(const neoled_backend_t* backend, int port, bool realtime, int frames)
+{
+    Host::setRealtime(realtime);
+    Strip strip(LEDS);
+    if (backend != NULL) {
+        CHECK(strip.setBackend(backend) == NEOLED_OK);
+    }
+    CHECK(strip.initWithPin(5, port) == NEOLED_OK);
+    CHECK(strip.setBackend(i2sBackend()) == NEOLED_ERR_INIT);
+    Host::resetCapture(port);
+
+    std::vector<Pixel> pixels(LEDS);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        for (int i = 0; i < LEDS; i++) {
+            pixels[i] = makePixel((uint8_t)(i + f), (uint8_t)f, (uint8_t)(i * 3));
+        }
+        CHECK(strip.update(pixels.data()) == NEOLED_OK);
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    Run result;
+    result.stream = captured(port);
+    result.cpu_us = us / frames;
+    result.fps = frames / (us / 1e6);
+    result.wire_us = Host::wireTimeUs(port);
+    CHECK(Host::writeCount(port) == (uint32_t)frames);
+    strip.destroy();
+    return result;
+}
+
+int main()
+{
+    Run i2s = run(NULL, 0, false, 1000);
+    Run capture = run(Host::captureBackend(), 1, false, 1000);
+    CHECK(!i2s.stream.empty() && i2s.stream == capture.stream);
+    printf("%d LEDs: i2s %.1f us/frame, capture %.1f us/frame CPU\n", LEDS, i2s.cpu_us, capture.cpu_us);
+
+    // With real-time simulation the wire, not the encoder, sets the frame rate
+    const int frames = 30;
+    Run realtime = run(Host::captureBackend(), 1, true, frames);
+    double wire_fps = frames / (realtime.wire_us / 1e6);
+    CHECK(realtime.wire_us > 0);
+    CHECK(realtime.fps <= wire_fps * 1.01);
+    printf("%d LEDs: %.1f fps real time, wire limit %.1f fps\n", LEDS, realtime.fps, wire_fps);
+
+    return testResult();
+}
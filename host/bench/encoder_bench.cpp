@@ -0,0 +1,69 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Encoder benchmark: CPU time per pixel of update() with the wire-time sleep
+// off. Built once per encoder (NEOLED_ENCODER_LUT=1 and 0) with
+// LED_NUMBER=1500.
+
+#include <chrono>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+int main()
+{
+    const int frames = 2000;
+    Host::setRealtime(false);
+
+    CHECK(init() == NEOLED_OK);
+    setBrightness(200);
+    Host::resetCapture(0);
+
+    std::vector<Pixel> pixels(LED_NUMBER);
+    for (int i = 0; i < LED_NUMBER; i++) {
+        pixels[i] = colorWheel((uint8_t)i);
+    }
+
+    // Change every pixel each frame so nothing can be skipped; the capture
+    // is cleared each frame so the timing is not its memory growth
+    size_t bytes = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        for (int i = 0; i < LED_NUMBER; i++) {
+            pixels[i].red++;
+        }
+        CHECK(update(pixels.data()) == NEOLED_OK);
+        size_t size = 0;
+        Host::captureData(0, &size);
+        bytes += size;
+        Host::resetCapture(0);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%s encoder: %.2f ns/pixel (%d LEDs, %d frames)\n",
+           NEOLED_ENCODER_LUT ? "lookup table" : "2-bit bitpatterns", ns / frames / LED_NUMBER, LED_NUMBER, frames);
+    CHECK(bytes >= (size_t)frames * LED_NUMBER * PIXEL_SIZE);
+
+    destroy();
+    return testResult();
+}
@@ -0,0 +1,74 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Parallel encoder benchmark: time per frame of the transpose kernel
+// against the bit-by-bit reference, for 8 and 16 lanes
+
+#include <chrono>
+#include <cstdlib>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+typedef void (*ParallelEncoder)(const Pixel* const*, uint8_t, uint16_t, uint8_t*);
+
+static double timeFrame(ParallelEncoder encode, const Pixel* const* lanes, uint8_t lane_count,
+                        uint16_t led_count, uint8_t* out, int frames)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        encode(lanes, lane_count, led_count, out);
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+int main()
+{
+    const uint16_t led_count = 500;
+    const int frames = 100;
+
+    srand(1);
+    std::vector<std::vector<Pixel> > pixels(16, std::vector<Pixel>(led_count));
+    const Pixel* lanes[16];
+    for (int l = 0; l < 16; l++) {
+        for (int i = 0; i < led_count; i++) {
+            randomPixel(pixels[l][i]);
+        }
+        lanes[l] = pixels[l].data();
+    }
+
+    for (uint8_t lane_count = 8; lane_count <= 16; lane_count += 8) {
+        size_t bytes = parallelFrameBytes(lane_count, led_count);
+        std::vector<uint8_t> expected(bytes);
+        std::vector<uint8_t> actual(bytes);
+
+        double reference_us = timeFrame(encodeParallelReference, lanes, lane_count, led_count, expected.data(), frames);
+        double kernel_us = timeFrame(encodeParallel, lanes, lane_count, led_count, actual.data(), frames);
+        CHECK(expected == actual);
+
+        printf("%2u lanes x %u LEDs: kernel %.1f us/frame, reference %.1f us/frame (%.1fx)\n",
+               lane_count, led_count, kernel_us, reference_us, reference_us / kernel_us);
+    }
+
+    return testResult();
+}
@@ -0,0 +1,99 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// RGBW benchmark: rgbToRgbw() time per pixel in each white mode, and the
+// cost of an RGBW frame (conversion included) against an RGB frame
+
+#include <chrono>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+int main()
+{
+    Host::setRealtime(false);
+
+    const int count = 1000;
+    const int rounds = 20000;
+    std::vector<Pixel> in(count);
+    std::vector<PixelW> out(count);
+    for (int i = 0; i < count; i++) {
+        in[i] = colorWheel((uint8_t)i);
+    }
+
+    const neoled_white_mode_t modes[] = {NEOLED_WHITE_NONE, NEOLED_WHITE_MIN, NEOLED_WHITE_TEMPERATURE};
+    const char* names[] = {"none", "min", "temperature"};
+    for (int m = 0; m < 3; m++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            in[r % count].blue = (uint8_t)r;
+            rgbToRgbw(in.data(), out.data(), count, modes[m]);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        printf("rgbToRgbw %-11s %.2f ns/pixel\n", names[m], ns / rounds / count);
+    }
+    rgbToRgbw(in.data(), out.data(), count, NEOLED_WHITE_MIN);
+    for (int i = 0; i < count; i++) {
+        CHECK(out[i].white == std::min(in[i].red, std::min(in[i].green, in[i].blue)));
+    }
+
+    // Every LED changes each frame, so dirty tracking skips nothing
+    const int leds = 300;
+    const int frames = 2000;
+    Strip rgb(leds);
+    rgb.setBackend(Host::captureBackend());
+    rgb.setProtocol(NEOLED_SK6812);
+    CHECK(rgb.initWithPin(18, 0) == NEOLED_OK);
+    Strip rgbw(leds);
+    rgbw.setBackend(Host::captureBackend());
+    rgbw.setProtocol(NEOLED_SK6812_RGBW);
+    CHECK(rgbw.initWithPin(18, 1) == NEOLED_OK);
+
+    std::vector<Pixel> pixels(leds);
+    std::vector<PixelW> pixels_w(leds);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        for (int i = 0; i < leds; i++) {
+            pixels[i] = colorWheel((uint8_t)(i + f));
+        }
+        CHECK(rgb.update(pixels.data()) == NEOLED_OK);
+        Host::resetCapture(0);
+    }
+    double rgb_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        for (int i = 0; i < leds; i++) {
+            pixels[i] = colorWheel((uint8_t)(i + f));
+        }
+        rgbToRgbw(pixels.data(), pixels_w.data(), leds, NEOLED_WHITE_MIN);
+        CHECK(rgbw.update(pixels_w.data()) == NEOLED_OK);
+        Host::resetCapture(1);
+    }
+    double rgbw_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+    printf("%d LEDs: RGB update %.1f us/frame, RGBW convert + update %.1f us/frame\n", leds, rgb_us, rgbw_us);
+
+    rgb.destroy();
+    rgbw.destroy();
+    return testResult();
+}
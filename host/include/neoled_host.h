@@ -0,0 +1,91 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Host build support: inspect what the driver stand-ins or capture backend sent
+// and how long it took
+#ifndef NEOLED_HOST_H
+#define NEOLED_HOST_H
+
+#include <cstddef>
+#include <cstdint>
+#include "neoled.h"
+
+namespace NeoLED {
+namespace Host {
+
+// Port number of the esp_lcd i80 bus used by ParallelStrip
+const int PARALLEL_PORT = -1;
+
+// Port number shared by all RMT TX channels; captures rmt_symbol_word_t values
+const int RMT_PORT = -2;
+
+// Port number shared by all SPI hosts; captures the MOSI byte stream
+const int SPI_PORT = -3;
+
+/**
+ * @brief Get a backend that records frames without the I2S driver stand-ins
+ * @return Backend writing to the same per-port capture as the I2S stand-in
+ * @note Use with Strip::setBackend(); ports 0 to SOC_I2S_NUM - 1
+ */
+const neoled_backend_t* captureBackend(void);
+
+/**
+ * @brief Enable or disable real-time wire simulation
+ * @param enable true (default) makes each write block for its wire time
+ *        at the configured sample rate, false returns immediately and also
+ *        skips the driver's vTaskDelay() waits
+ */
+void setRealtime(bool enable);
+
+/**
+ * @brief Get the bytes written to a port since the last resetCapture()
+ * @param port I2S port number, PARALLEL_PORT, RMT_PORT or SPI_PORT
+ * @param size Receives the number of captured bytes
+ * @return Pointer to the captured byte stream (valid until the next write)
+ */
+const uint8_t* captureData(int port, size_t* size);
+
+/**
+ * @brief Discard captured bytes and accumulated wire time for a port
+ * @param port I2S port number, PARALLEL_PORT, RMT_PORT or SPI_PORT
+ */
+void resetCapture(int port);
+
+/**
+ * @brief Get the simulated wire time of everything written to a port
+ * @param port I2S port number, PARALLEL_PORT, RMT_PORT or SPI_PORT
+ * @return Wire time in microseconds since the last resetCapture()
+ */
+uint64_t wireTimeUs(int port);
+
+/**
+ * @brief Get the number of writes (frames) sent on a port
+ * @param port I2S port number, PARALLEL_PORT, RMT_PORT or SPI_PORT
+ * @return Writes since the last resetCapture()
+ */
+uint32_t writeCount(int port);
+
+} // namespace Host
+} // namespace NeoLED
+
+#endif // NEOLED_HOST_H
@@ -0,0 +1,996 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+
+// Host (Linux/macOS) stand-ins for the ESP-IDF and FreeRTOS APIs used by
+// NeoLED, so the driver can be built, tested and timed without hardware:
+//
+//   g++ -std=c++11 -O2 -pthread -Iinclude -Ihost/include neoled.cpp host/neoled_host.cpp app.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "driver/i2s_std.h"
+#include "driver/rmt_tx.h"
+#include "driver/spi_master.h"
+#include "esp_lcd_panel_io.h"
+#include "soc/soc_caps.h"
+#include "neoled_host.h"
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+typedef std::chrono::steady_clock HostClock;
+
+static HostClock::time_point host_start = HostClock::now();
+static bool host_realtime = true;
+
+/**
+ * @brief Wait on a condition variable for up to the given number of ticks
+ * @return true if the predicate became true before the timeout
+ */
+template <typename Predicate>
+static bool waitTicks(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+                      TickType_t ticks, Predicate predicate)
+{
+    if (ticks == portMAX_DELAY) {
+        cv.wait(lock, predicate);
+        return true;
+    }
+    return cv.wait_for(lock, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), predicate);
+}
+
+const char* esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        default: return "UNKNOWN ERROR";
+    }
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num)
+{
+    (void)gpio_num;
+    return ESP_OK;
+}
+
+// ============================================================================
+// Tasks
+// ============================================================================
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stack_depth,
+                                   void* parameters, UBaseType_t priority, TaskHandle_t* created_task,
+                                   BaseType_t core_id)
+{
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+    (void)core_id;
+
+    std::thread(function, parameters).detach();
+    if (created_task != NULL) {
+        *created_task = NULL;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    (void)task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    // The driver only delays to let the wire catch up, which is not
+    // simulated with real time off
+    if (!host_realtime) {
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        HostClock::now() - host_start).count() / portTICK_PERIOD_MS;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(HostClock::now() - host_start).count();
+}
+
+// ============================================================================
+// Semaphores
+// ============================================================================
+
+struct HostSemaphore {
+    std::mutex mutex;
+    std::condition_variable cv;
+    UBaseType_t count;
+    UBaseType_t max_count;
+};
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    HostSemaphore* semaphore = new HostSemaphore();
+    semaphore->count = initial_count;
+    semaphore->max_count = max_count;
+    return semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    std::unique_lock<std::mutex> lock(semaphore->mutex);
+    if (!waitTicks(semaphore->cv, lock, ticks_to_wait, [semaphore] { return semaphore->count > 0; })) {
+        return pdFALSE;
+    }
+    semaphore->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    std::lock_guard<std::mutex> lock(semaphore->mutex);
+    if (semaphore->count >= semaphore->max_count) {
+        return pdFALSE;
+    }
+    semaphore->count++;
+    semaphore->cv.notify_one();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* higher_priority_task_woken)
+{
+    if (higher_priority_task_woken != NULL) {
+        *higher_priority_task_woken = pdFALSE;
+    }
+    return xSemaphoreGive(semaphore);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    delete semaphore;
+}
+
+// ============================================================================
+// Queues
+// ============================================================================
+
+struct HostQueue {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::vector<uint8_t> > items;
+    UBaseType_t length;
+    UBaseType_t item_size;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    HostQueue* queue = new HostQueue();
+    queue->length = length;
+    queue->item_size = item_size;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks_to_wait)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitTicks(queue->cv, lock, ticks_to_wait, [queue] { return queue->items.size() < queue->length; })) {
+        return pdFALSE;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(item);
+    queue->items.push_back(std::vector<uint8_t>(bytes, bytes + queue->item_size));
+    queue->cv.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* buffer, TickType_t ticks_to_wait)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitTicks(queue->cv, lock, ticks_to_wait, [queue] { return !queue->items.empty(); })) {
+        return pdFALSE;
+    }
+    memcpy(buffer, queue->items.front().data(), queue->item_size);
+    queue->items.pop_front();
+    queue->cv.notify_all();
+    return pdTRUE;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    delete queue;
+}
+
+// ============================================================================
+// I2S Channels
+// ============================================================================
+
+struct i2s_channel_obj_t {
+    int port;
+    uint32_t sample_rate_hz;
+    bool enabled;
+};
+
+struct HostPort {
+    std::mutex mutex;
+    bool allocated;
+    std::vector<uint8_t> capture;
+    uint64_t wire_time_us;
+    uint32_t write_count;
+};
+
+static HostPort host_ports[SOC_I2S_NUM];
+static HostPort host_parallel;  // esp_lcd i80 bus
+static HostPort host_rmt;       // All RMT TX channels
+static HostPort host_spi;       // All SPI hosts
+
+/**
+ * @brief Look up a captured port (NeoLED::Host::PARALLEL_PORT for the i80 bus,
+ *        NeoLED::Host::RMT_PORT for the RMT channels, NeoLED::Host::SPI_PORT
+ *        for the SPI hosts)
+ */
+static HostPort& hostPort(int port)
+{
+    if (port == NeoLED::Host::PARALLEL_PORT) {
+        return host_parallel;
+    }
+    if (port == NeoLED::Host::RMT_PORT) {
+        return host_rmt;
+    }
+    if (port == NeoLED::Host::SPI_PORT) {
+        return host_spi;
+    }
+    return host_ports[port];
+}
+
+/**
+ * @brief Record bytes sent on a port and block for their wire time
+ */
+static void hostSend(HostPort& port, const void* src, size_t size, uint64_t wire_us)
+{
+    {
+        std::lock_guard<std::mutex> lock(port.mutex);
+        const uint8_t* bytes = static_cast<const uint8_t*>(src);
+        port.capture.insert(port.capture.end(), bytes, bytes + size);
+        port.wire_time_us += wire_us;
+        port.write_count++;
+    }
+
+    if (host_realtime) {
+        std::this_thread::sleep_for(std::chrono::microseconds(wire_us));
+    }
+}
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t* chan_cfg, i2s_chan_handle_t* ret_tx_handle,
+                          i2s_chan_handle_t* ret_rx_handle)
+{
+    if (chan_cfg == NULL || ret_tx_handle == NULL || ret_rx_handle != NULL ||
+        chan_cfg->id < 0 || chan_cfg->id >= SOC_I2S_NUM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    HostPort& port = host_ports[chan_cfg->id];
+    std::lock_guard<std::mutex> lock(port.mutex);
+    if (port.allocated) {
+        return ESP_ERR_NO_MEM;  // Same as the IDF driver when the port is taken
+    }
+    port.allocated = true;
+
+    i2s_channel_obj_t* channel = new i2s_channel_obj_t();
+    channel->port = chan_cfg->id;
+    channel->sample_rate_hz = 0;
+    channel->enabled = false;
+    *ret_tx_handle = channel;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t handle, const i2s_std_config_t* std_cfg)
+{
+    if (handle == NULL || std_cfg == NULL || std_cfg->clk_cfg.sample_rate_hz == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    handle->sample_rate_hz = std_cfg->clk_cfg.sample_rate_hz;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_enable(i2s_chan_handle_t handle)
+{
+    if (handle == NULL || handle->sample_rate_hz == 0 || handle->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    handle->enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_disable(i2s_chan_handle_t handle)
+{
+    if (handle == NULL || !handle->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    handle->enabled = false;
+    return ESP_OK;
+}
+
+esp_err_t i2s_del_channel(i2s_chan_handle_t handle)
+{
+    if (handle == NULL || handle->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    HostPort& port = host_ports[handle->port];
+    {
+        std::lock_guard<std::mutex> lock(port.mutex);
+        port.allocated = false;
+    }
+    delete handle;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_write(i2s_chan_handle_t handle, const void* src, size_t size,
+                            size_t* bytes_written, uint32_t timeout_ms)
+{
+    (void)timeout_ms;
+
+    if (handle == NULL || !handle->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // 16-bit stereo: four bytes per sample frame
+    uint64_t wire_us = (uint64_t)size * 1000000ULL / ((uint64_t)handle->sample_rate_hz * 4);
+
+    hostSend(host_ports[handle->port], src, size, wire_us);
+
+    if (bytes_written != NULL) {
+        *bytes_written = size;
+    }
+    return ESP_OK;
+}
+
+// ============================================================================
+// LCD i80 Bus
+// ============================================================================
+
+struct esp_lcd_i80_bus_t {
+    size_t bus_width;
+    size_t max_transfer_bytes;
+};
+
+struct esp_lcd_panel_io_t {
+    esp_lcd_i80_bus_t* bus;
+    uint32_t pclk_hz;
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    void* user_ctx;
+};
+
+esp_err_t esp_lcd_new_i80_bus(const esp_lcd_i80_bus_config_t* bus_config, esp_lcd_i80_bus_handle_t* ret_bus)
+{
+    if (bus_config == NULL || ret_bus == NULL ||
+        (bus_config->bus_width != 8 && bus_config->bus_width != 16)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    std::lock_guard<std::mutex> lock(host_parallel.mutex);
+    if (host_parallel.allocated) {
+        return ESP_ERR_NOT_FOUND;  // Same as the IDF driver when no bus is free
+    }
+    host_parallel.allocated = true;
+
+    esp_lcd_i80_bus_t* bus = new esp_lcd_i80_bus_t();
+    bus->bus_width = bus_config->bus_width;
+    bus->max_transfer_bytes = bus_config->max_transfer_bytes;
+    *ret_bus = bus;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_del_i80_bus(esp_lcd_i80_bus_handle_t bus)
+{
+    if (bus == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(host_parallel.mutex);
+        host_parallel.allocated = false;
+    }
+    delete bus;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_io_i80(esp_lcd_i80_bus_handle_t bus, const esp_lcd_panel_io_i80_config_t* io_config,
+                                   esp_lcd_panel_io_handle_t* ret_io)
+{
+    if (bus == NULL || io_config == NULL || ret_io == NULL || io_config->pclk_hz == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_lcd_panel_io_t* io = new esp_lcd_panel_io_t();
+    io->bus = bus;
+    io->pclk_hz = io_config->pclk_hz;
+    io->on_color_trans_done = io_config->on_color_trans_done;
+    io->user_ctx = io_config->user_ctx;
+    *ret_io = io;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_del(esp_lcd_panel_io_handle_t io)
+{
+    delete io;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void* color, size_t color_size)
+{
+    (void)lcd_cmd;
+
+    if (io == NULL || color == NULL || color_size > io->bus->max_transfer_bytes) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // One sample (bus_width bits) per clock
+    uint64_t samples = color_size / (io->bus->bus_width / 8);
+    hostSend(host_parallel, color, color_size, samples * 1000000ULL / io->pclk_hz);
+
+    if (io->on_color_trans_done != NULL) {
+        io->on_color_trans_done(io, NULL, io->user_ctx);
+    }
+    return ESP_OK;
+}
+
+// ============================================================================
+// RMT TX Channels
+// ============================================================================
+
+struct rmt_channel_t {
+    uint32_t resolution_hz;
+    size_t mem_symbols;
+    bool enabled;
+    std::vector<rmt_symbol_word_t> memory;  // Symbols waiting in channel memory
+};
+
+static int host_rmt_channels = 0;
+
+/**
+ * @brief Number of symbols the encoder may still write to channel memory
+ */
+static size_t rmtFree(rmt_channel_handle_t channel)
+{
+    return channel->mem_symbols - channel->memory.size();
+}
+
+esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t* config, rmt_channel_handle_t* ret_chan)
+{
+    if (config == NULL || ret_chan == NULL || config->resolution_hz == 0 || config->mem_block_symbols < 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    HostPort& port = hostPort(NeoLED::Host::RMT_PORT);
+    std::lock_guard<std::mutex> lock(port.mutex);
+    if (host_rmt_channels >= SOC_RMT_TX_CANDIDATES_PER_GROUP) {
+        return ESP_ERR_NOT_FOUND;  // Same as the IDF driver when no channel is free
+    }
+    host_rmt_channels++;
+
+    rmt_channel_t* channel = new rmt_channel_t();
+    channel->resolution_hz = config->resolution_hz;
+    channel->mem_symbols = config->mem_block_symbols;
+    channel->enabled = false;
+    *ret_chan = channel;
+    return ESP_OK;
+}
+
+esp_err_t rmt_del_channel(rmt_channel_handle_t channel)
+{
+    if (channel == NULL || channel->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    HostPort& port = hostPort(NeoLED::Host::RMT_PORT);
+    {
+        std::lock_guard<std::mutex> lock(port.mutex);
+        host_rmt_channels--;
+    }
+    delete channel;
+    return ESP_OK;
+}
+
+esp_err_t rmt_enable(rmt_channel_handle_t channel)
+{
+    if (channel == NULL || channel->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    channel->enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t rmt_disable(rmt_channel_handle_t channel)
+{
+    if (channel == NULL || !channel->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    channel->enabled = false;
+    return ESP_OK;
+}
+
+esp_err_t rmt_transmit(rmt_channel_handle_t tx_channel, rmt_encoder_handle_t encoder,
+                       const void* payload, size_t payload_bytes, const rmt_transmit_config_t* config)
+{
+    if (tx_channel == NULL || encoder == NULL || payload == NULL || config == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!tx_channel->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Call the encoder as the driver's ISR would: once up front, then each
+    // time the hardware has sent half of the channel memory
+    std::vector<rmt_symbol_word_t> sent;
+    uint64_t ticks = 0;
+    rmt_encode_state_t state = RMT_ENCODING_RESET;
+    tx_channel->memory.clear();
+    do {
+        encoder->encode(encoder, tx_channel, payload, payload_bytes, &state);
+
+        size_t drain = (state & RMT_ENCODING_COMPLETE) ? tx_channel->memory.size()
+                                                       : std::min(tx_channel->memory.size(), tx_channel->mem_symbols / 2);
+        if (drain == 0 && !(state & RMT_ENCODING_COMPLETE)) {
+            return ESP_FAIL;  // Encoder made no progress
+        }
+        for (size_t i = 0; i < drain; i++) {
+            ticks += tx_channel->memory[i].duration0 + tx_channel->memory[i].duration1;
+        }
+        sent.insert(sent.end(), tx_channel->memory.begin(), tx_channel->memory.begin() + drain);
+        tx_channel->memory.erase(tx_channel->memory.begin(), tx_channel->memory.begin() + drain);
+    } while (!(state & RMT_ENCODING_COMPLETE));
+
+    hostSend(hostPort(NeoLED::Host::RMT_PORT), sent.data(), sent.size() * sizeof(rmt_symbol_word_t),
+             ticks * 1000000ULL / tx_channel->resolution_hz);
+    return ESP_OK;
+}
+
+esp_err_t rmt_tx_wait_all_done(rmt_channel_handle_t tx_channel, int timeout_ms)
+{
+    (void)timeout_ms;
+    return tx_channel == NULL ? ESP_ERR_INVALID_ARG : ESP_OK;  // Transmissions block for their wire time
+}
+
+// Bytes encoder: one symbol per bit, resumable when channel memory fills
+struct HostBytesEncoder {
+    rmt_encoder_t base;
+    rmt_symbol_word_t bit0;
+    rmt_symbol_word_t bit1;
+    bool msb_first;
+    size_t position;  // Bits already encoded
+};
+
+static size_t hostBytesEncode(rmt_encoder_t* encoder, rmt_channel_handle_t channel,
+                              const void* primary_data, size_t data_size, rmt_encode_state_t* ret_state)
+{
+    HostBytesEncoder* e = reinterpret_cast<HostBytesEncoder*>(encoder);
+    const uint8_t* bytes = static_cast<const uint8_t*>(primary_data);
+    size_t encoded = 0;
+
+    while (e->position < data_size * 8 && rmtFree(channel) > 0) {
+        size_t bit = e->position % 8;
+        uint8_t value = bytes[e->position / 8] >> (e->msb_first ? 7 - bit : bit) & 0x01;
+        channel->memory.push_back(value ? e->bit1 : e->bit0);
+        e->position++;
+        encoded++;
+    }
+
+    int state = RMT_ENCODING_RESET;
+    if (e->position == data_size * 8) {
+        e->position = 0;
+        state |= RMT_ENCODING_COMPLETE;
+    }
+    if (rmtFree(channel) == 0) {
+        state |= RMT_ENCODING_MEM_FULL;
+    }
+    *ret_state = (rmt_encode_state_t)state;
+    return encoded;
+}
+
+// Copy encoder: copies rmt_symbol_word_t values, resumable when memory fills
+struct HostCopyEncoder {
+    rmt_encoder_t base;
+    size_t position;  // Symbols already copied
+};
+
+static size_t hostCopyEncode(rmt_encoder_t* encoder, rmt_channel_handle_t channel,
+                             const void* primary_data, size_t data_size, rmt_encode_state_t* ret_state)
+{
+    HostCopyEncoder* e = reinterpret_cast<HostCopyEncoder*>(encoder);
+    const rmt_symbol_word_t* symbols = static_cast<const rmt_symbol_word_t*>(primary_data);
+    size_t count = data_size / sizeof(rmt_symbol_word_t);
+    size_t encoded = 0;
+
+    while (e->position < count && rmtFree(channel) > 0) {
+        channel->memory.push_back(symbols[e->position++]);
+        encoded++;
+    }
+
+    int state = RMT_ENCODING_RESET;
+    if (e->position == count) {
+        e->position = 0;
+        state |= RMT_ENCODING_COMPLETE;
+    }
+    if (rmtFree(channel) == 0) {
+        state |= RMT_ENCODING_MEM_FULL;
+    }
+    *ret_state = (rmt_encode_state_t)state;
+    return encoded;
+}
+
+static esp_err_t hostBytesReset(rmt_encoder_t* encoder)
+{
+    reinterpret_cast<HostBytesEncoder*>(encoder)->position = 0;
+    return ESP_OK;
+}
+
+static esp_err_t hostBytesDelete(rmt_encoder_t* encoder)
+{
+    delete reinterpret_cast<HostBytesEncoder*>(encoder);
+    return ESP_OK;
+}
+
+static esp_err_t hostCopyReset(rmt_encoder_t* encoder)
+{
+    reinterpret_cast<HostCopyEncoder*>(encoder)->position = 0;
+    return ESP_OK;
+}
+
+static esp_err_t hostCopyDelete(rmt_encoder_t* encoder)
+{
+    delete reinterpret_cast<HostCopyEncoder*>(encoder);
+    return ESP_OK;
+}
+
+esp_err_t rmt_new_bytes_encoder(const rmt_bytes_encoder_config_t* config, rmt_encoder_handle_t* ret_encoder)
+{
+    if (config == NULL || ret_encoder == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    HostBytesEncoder* e = new HostBytesEncoder();
+    e->base.encode = hostBytesEncode;
+    e->base.reset = hostBytesReset;
+    e->base.del = hostBytesDelete;
+    e->bit0 = config->bit0;
+    e->bit1 = config->bit1;
+    e->msb_first = config->flags.msb_first;
+    e->position = 0;
+    *ret_encoder = &e->base;
+    return ESP_OK;
+}
+
+esp_err_t rmt_new_copy_encoder(const rmt_copy_encoder_config_t* config, rmt_encoder_handle_t* ret_encoder)
+{
+    if (config == NULL || ret_encoder == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    HostCopyEncoder* e = new HostCopyEncoder();
+    e->base.encode = hostCopyEncode;
+    e->base.reset = hostCopyReset;
+    e->base.del = hostCopyDelete;
+    e->position = 0;
+    *ret_encoder = &e->base;
+    return ESP_OK;
+}
+
+esp_err_t rmt_del_encoder(rmt_encoder_handle_t encoder)
+{
+    return encoder == NULL ? ESP_ERR_INVALID_ARG : encoder->del(encoder);
+}
+
+esp_err_t rmt_encoder_reset(rmt_encoder_handle_t encoder)
+{
+    return encoder == NULL ? ESP_ERR_INVALID_ARG : encoder->reset(encoder);
+}
+
+// ============================================================================
+// SPI Master
+// ============================================================================
+
+struct spi_device_t {
+    spi_host_device_t host;
+    int clock_speed_hz;
+    size_t queue_size;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<spi_transaction_t*> queued;  // Waiting for or on the wire
+    std::deque<spi_transaction_t*> done;    // Sent, not yet collected
+    bool stop;
+    std::thread worker;
+};
+
+static bool host_spi_buses[SPI_HOST_MAX];
+static bool host_spi_devices[SPI_HOST_MAX];
+
+/**
+ * @brief Send a device's queued transactions in order, reading each TX
+ *        buffer only when its turn comes, as the DMA does
+ */
+static void spiDeviceWorker(spi_device_t* device)
+{
+    std::unique_lock<std::mutex> lock(device->mutex);
+    while (true) {
+        device->cv.wait(lock, [device] { return device->stop || !device->queued.empty(); });
+        if (device->queued.empty()) {
+            return;
+        }
+
+        spi_transaction_t* t = device->queued.front();
+        lock.unlock();
+        size_t bytes = t->length / 8;
+        hostSend(hostPort(NeoLED::Host::SPI_PORT), t->tx_buffer, bytes,
+                 (uint64_t)t->length * 1000000ULL / device->clock_speed_hz);
+        lock.lock();
+
+        device->queued.pop_front();
+        device->done.push_back(t);
+        device->cv.notify_all();
+    }
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t* bus_config, spi_dma_chan_t dma_chan)
+{
+    (void)dma_chan;
+
+    if (host_id <= SPI1_HOST || host_id >= SPI_HOST_MAX || bus_config == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    HostPort& port = hostPort(NeoLED::Host::SPI_PORT);
+    std::lock_guard<std::mutex> lock(port.mutex);
+    if (host_spi_buses[host_id]) {
+        return ESP_ERR_INVALID_STATE;  // Same as the IDF driver when the host is in use
+    }
+    host_spi_buses[host_id] = true;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host_id)
+{
+    HostPort& port = hostPort(NeoLED::Host::SPI_PORT);
+    std::lock_guard<std::mutex> lock(port.mutex);
+    if (host_id <= SPI1_HOST || host_id >= SPI_HOST_MAX || !host_spi_buses[host_id] || host_spi_devices[host_id]) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    host_spi_buses[host_id] = false;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host_id, const spi_device_interface_config_t* dev_config,
+                             spi_device_handle_t* handle)
+{
+    if (host_id <= SPI1_HOST || host_id >= SPI_HOST_MAX || dev_config == NULL || handle == NULL ||
+        dev_config->clock_speed_hz <= 0 || dev_config->queue_size <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    {
+        HostPort& port = hostPort(NeoLED::Host::SPI_PORT);
+        std::lock_guard<std::mutex> lock(port.mutex);
+        if (!host_spi_buses[host_id] || host_spi_devices[host_id]) {
+            return ESP_ERR_INVALID_STATE;  // One device per host is all NeoLED needs
+        }
+        host_spi_devices[host_id] = true;
+    }
+
+    spi_device_t* device = new spi_device_t();
+    device->host = host_id;
+    device->clock_speed_hz = dev_config->clock_speed_hz;
+    device->queue_size = (size_t)dev_config->queue_size;
+    device->stop = false;
+    device->worker = std::thread(spiDeviceWorker, device);
+    *handle = device;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle)
+{
+    if (handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(handle->mutex);
+        if (!handle->queued.empty() || !handle->done.empty()) {
+            return ESP_ERR_INVALID_STATE;  // Transactions still pending
+        }
+        handle->stop = true;
+        handle->cv.notify_all();
+    }
+    handle->worker.join();
+
+    {
+        HostPort& port = hostPort(NeoLED::Host::SPI_PORT);
+        std::lock_guard<std::mutex> lock(port.mutex);
+        host_spi_devices[handle->host] = false;
+    }
+    delete handle;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t* trans_desc, TickType_t ticks_to_wait)
+{
+    if (handle == NULL || trans_desc == NULL || trans_desc->tx_buffer == NULL || trans_desc->length % 8 != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    std::unique_lock<std::mutex> lock(handle->mutex);
+    if (!waitTicks(handle->cv, lock, ticks_to_wait,
+                   [handle] { return handle->queued.size() + handle->done.size() < handle->queue_size; })) {
+        return ESP_ERR_TIMEOUT;
+    }
+    handle->queued.push_back(trans_desc);
+    handle->cv.notify_all();
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t** trans_desc,
+                                      TickType_t ticks_to_wait)
+{
+    if (handle == NULL || trans_desc == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    std::unique_lock<std::mutex> lock(handle->mutex);
+    if (!waitTicks(handle->cv, lock, ticks_to_wait, [handle] { return !handle->done.empty(); })) {
+        return ESP_ERR_TIMEOUT;
+    }
+    *trans_desc = handle->done.front();
+    handle->done.pop_front();
+    handle->cv.notify_all();
+    return ESP_OK;
+}
+
+// ============================================================================
+// Capture Backend
+// ============================================================================
+
+struct CaptureBackend {
+    int port;
+    uint32_t sample_rate;
+};
+
+static NeoLED::neoled_err_t captureInit(const NeoLED::neoled_backend_config_t* config, void** handle)
+{
+    if (config->port < 0 || config->port >= SOC_I2S_NUM || config->sample_rate == 0) {
+        return NeoLED::NEOLED_ERR_PARAM;
+    }
+
+    HostPort& port = host_ports[config->port];
+    std::lock_guard<std::mutex> lock(port.mutex);
+    if (port.allocated) {
+        return NeoLED::NEOLED_ERR_INIT;
+    }
+    port.allocated = true;
+
+    CaptureBackend* b = new CaptureBackend();
+    b->port = config->port;
+    b->sample_rate = config->sample_rate;
+    *handle = b;
+    return NeoLED::NEOLED_OK;
+}
+
+static NeoLED::neoled_err_t captureWrite(void* handle, const uint8_t* data, size_t length)
+{
+    CaptureBackend* b = static_cast<CaptureBackend*>(handle);
+
+    // Same wire time as the I2S stream: four bytes per sample frame
+    uint64_t wire_us = (uint64_t)length * 1000000ULL / ((uint64_t)b->sample_rate * 4);
+    hostSend(host_ports[b->port], data, length, wire_us);
+    return NeoLED::NEOLED_OK;
+}
+
+static NeoLED::neoled_err_t captureFlush(void* handle, uint32_t timeout_ms)
+{
+    (void)handle;
+    (void)timeout_ms;
+    return NeoLED::NEOLED_OK;  // Writes already block for their wire time
+}
+
+static void captureDeinit(void* handle)
+{
+    CaptureBackend* b = static_cast<CaptureBackend*>(handle);
+    {
+        std::lock_guard<std::mutex> lock(host_ports[b->port].mutex);
+        host_ports[b->port].allocated = false;
+    }
+    delete b;
+}
+
+static const NeoLED::neoled_backend_t capture_backend = {
+    "capture", NeoLED::NEOLED_FRAME_I2S, captureInit, captureWrite, captureFlush, captureDeinit
+};
+
+// ============================================================================
+// Host Inspection API
+// ============================================================================
+
+namespace NeoLED {
+namespace Host {
+
+const neoled_backend_t* captureBackend(void)
+{
+    return &capture_backend;
+}
+
+void setRealtime(bool enable)
+{
+    host_realtime = enable;
+}
+
+const uint8_t* captureData(int port, size_t* size)
+{
+    HostPort& host_port = hostPort(port);
+    std::lock_guard<std::mutex> lock(host_port.mutex);
+    *size = host_port.capture.size();
+    return host_port.capture.data();
+}
+
+void resetCapture(int port)
+{
+    HostPort& host_port = hostPort(port);
+    std::lock_guard<std::mutex> lock(host_port.mutex);
+    host_port.capture.clear();
+    host_port.wire_time_us = 0;
+    host_port.write_count = 0;
+}
+
+uint64_t wireTimeUs(int port)
+{
+    HostPort& host_port = hostPort(port);
+    std::lock_guard<std::mutex> lock(host_port.mutex);
+    return host_port.wire_time_us;
+}
+
+uint32_t writeCount(int port)
+{
+    HostPort& host_port = hostPort(port);
+    std::lock_guard<std::mutex> lock(host_port.mutex);
+    return host_port.write_count;
+}
+
+} // namespace Host
+} // namespace NeoLED
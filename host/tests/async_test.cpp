@@ -0,0 +1,153 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Async test: with auto-prefix on, updateAsync() and showAsync() frames must
+// leave the LEDs showing the last frame queued, whichever buffer it used.
+// Built with LED_NUMBER=24.
+
+#include "host_test.h"
+
+using namespace NeoLED;
+
+static const Pixel OFF = makePixel(0, 0, 0);
+static const Pixel RED = makePixel(255, 0, 0);
+
+/**
+ * @brief Check the simulated LEDs against the frame they should show
+ */
+static bool showsFrame(const std::vector<uint8_t>& leds, const std::vector<Pixel>& frame)
+{
+    for (size_t i = 0; i < frame.size(); i++) {
+        if (leds[i * 3] != frame[i].green || leds[i * 3 + 1] != frame[i].red || leds[i * 3 + 2] != frame[i].blue) {
+            printf("LED %u shows %02x%02x%02x, expected %02x%02x%02x\n", (unsigned)i, leds[i * 3 + 1],
+                   leds[i * 3], leds[i * 3 + 2], frame[i].red, frame[i].green, frame[i].blue);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief One LED lit between two all-off async frames, then a sync frame
+ */
+static void checkSequence(void)
+{
+    setAutoPrefix(true);
+    Host::resetCapture(0);
+    CHECK(init() == NEOLED_OK);
+    CHECK(waitForUpdate(UINT32_MAX) == NEOLED_OK);
+
+    std::vector<uint8_t> leds(LED_NUMBER * 3, 0xff);
+    latchCapture(leds);
+    std::vector<Pixel> off(LED_NUMBER, OFF);
+    std::vector<Pixel> lit(off);
+    lit[5] = RED;
+
+    CHECK(updateAsync(off.data()) == NEOLED_OK);
+    CHECK(updateAsync(lit.data()) == NEOLED_OK);
+    CHECK(updateAsync(off.data()) == NEOLED_OK);
+    CHECK(waitForUpdate(UINT32_MAX) == NEOLED_OK);
+    latchCapture(leds);
+    CHECK(showsFrame(leds, off));
+
+    CHECK(update(off.data()) == NEOLED_OK);
+    latchCapture(leds);
+    CHECK(showsFrame(leds, off));
+
+    destroy();
+}
+
+/**
+ * @brief Random sparse changes sent through a random mix of sync and
+ *        async paths, from an array or the framebuffer
+ */
+static void checkRandom(unsigned seed, bool framebuffer)
+{
+    srand(seed);
+
+    setAutoPrefix(true);
+    Host::resetCapture(0);
+    CHECK(init() == NEOLED_OK);
+    CHECK(waitForUpdate(UINT32_MAX) == NEOLED_OK);
+
+    std::vector<uint8_t> leds(LED_NUMBER * 3, 0xff);
+    latchCapture(leds);
+    std::vector<Pixel> frame(LED_NUMBER, OFF);
+    if (framebuffer) {
+        // The default strip keeps its framebuffer from the previous run
+        for (int i = 0; i < LED_NUMBER; i++) {
+            CHECK(setPixel((uint16_t)i, OFF) == NEOLED_OK);
+        }
+    }
+
+    for (int step = 0; step < 300; step++) {
+        int changes = rand() % 3;
+        for (int c = 0; c < changes; c++) {
+            int i = rand() % LED_NUMBER;
+            if ((rand() & 1) != 0) {
+                frame[i] = RED;
+            } else {
+                randomPixel(frame[i]);
+            }
+            if (rand() % 4 == 0) {
+                frame[i] = OFF;
+            }
+            if (framebuffer) {
+                CHECK(setPixel((uint16_t)i, frame[i]) == NEOLED_OK);
+            }
+        }
+
+        bool async = rand() % 4 != 0;
+        if (framebuffer) {
+            CHECK((async ? showAsync() : show()) == NEOLED_OK);
+        } else {
+            CHECK((async ? updateAsync(frame.data()) : update(frame.data())) == NEOLED_OK);
+        }
+
+        // Look at the LEDs after a random number of queued frames
+        if (rand() % 3 == 0) {
+            CHECK(waitForUpdate(UINT32_MAX) == NEOLED_OK);
+            latchCapture(leds);
+            if (!showsFrame(leds, frame)) {
+                printf("seed %u step %d (%s)\n", seed, step, framebuffer ? "framebuffer" : "array");
+                CHECK(false);
+                break;
+            }
+        }
+    }
+
+    destroy();
+}
+
+int main()
+{
+    Host::setRealtime(false);
+
+    checkSequence();
+    for (unsigned seed = 1; seed <= 8; seed++) {
+        checkRandom(seed, false);
+        checkRandom(seed, true);
+    }
+
+    return testResult();
+}
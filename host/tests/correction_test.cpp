@@ -0,0 +1,238 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Colour correction test: a corrected strip sends the same stream as an
+// uncorrected one fed the corrected values, counts the corrected levels in
+// its current estimate, and dithers towards the corrected level
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+static const int LEDS = 41;
+static const float STRIP_GAMMA = 2.0f;
+static const neoled_color_correction_t CORRECTION = {255, 176, 240, 200, 0.0f, 2.8f, 0.0f, 1.8f};
+
+/**
+ * @brief Reference level of one channel: gamma, then white balance scale and brightness
+ */
+static uint8_t corrected(uint8_t value, float gamma, uint8_t scale, uint8_t brightness)
+{
+    uint32_t level = value;
+    if (gamma != 1.0f) {
+        level = (uint32_t)(powf(value / 255.0f, gamma) * 255.0f + 0.5f);
+    }
+    return (uint8_t)(level * scale * brightness / 65025);
+}
+
+static Pixel corrected(const Pixel& pixel, uint8_t brightness)
+{
+    return makePixel(corrected(pixel.red, STRIP_GAMMA, CORRECTION.red, brightness),
+                     corrected(pixel.green, CORRECTION.gamma_green, CORRECTION.green, brightness),
+                     corrected(pixel.blue, STRIP_GAMMA, CORRECTION.blue, brightness));
+}
+
+static PixelW corrected(const PixelW& pixel, uint8_t brightness)
+{
+    PixelW out;
+    out.red = corrected(pixel.red, STRIP_GAMMA, CORRECTION.red, brightness);
+    out.green = corrected(pixel.green, CORRECTION.gamma_green, CORRECTION.green, brightness);
+    out.blue = corrected(pixel.blue, STRIP_GAMMA, CORRECTION.blue, brightness);
+    out.white = corrected(pixel.white, CORRECTION.gamma_white, CORRECTION.white, brightness);
+    return out;
+}
+
+/**
+ * @brief Everything a strip sends for a few updates, with dirty tracking
+ *        skipping the unchanged LEDs of the later ones
+ */
+template <typename P>
+static std::vector<uint8_t> stream(neoled_protocol_t protocol, neoled_color_order_t order,
+                                   const neoled_color_correction_t* correction, uint8_t brightness, float gamma,
+                                   const std::vector<P>& pixels, const std::vector<P>& changed, uint32_t* current_ma)
+{
+    return captureStrip(
+        LEDS, Host::captureBackend(),
+        [&](Strip& strip) {
+            strip.setProtocol(protocol);
+            strip.setColorOrder(order);
+            strip.setBrightness(brightness);
+            strip.setGamma(gamma);
+            CHECK(strip.setColorCorrection(correction) == NEOLED_OK);
+        },
+        [&](Strip& strip) {
+            CHECK(strip.update(pixels.data()) == NEOLED_OK);
+            CHECK(strip.update(pixels.data()) == NEOLED_OK);
+            CHECK(strip.update(changed.data()) == NEOLED_OK);
+            CHECK(strip.update(pixels.data()) == NEOLED_OK);
+            *current_ma = strip.getEstimatedCurrent();
+        });
+}
+
+template <typename P>
+static void checkStream(neoled_protocol_t protocol, const std::vector<P>& pixels, const std::vector<P>& changed)
+{
+    const uint8_t brightnesses[2] = {255, 180};
+    for (int o = NEOLED_ORDER_RGB; o <= NEOLED_ORDER_BGR; o++) {
+        for (int b = 0; b < 2; b++) {
+            std::vector<P> reference(LEDS), reference_changed(LEDS);
+            for (int i = 0; i < LEDS; i++) {
+                reference[i] = corrected(pixels[i], brightnesses[b]);
+                reference_changed[i] = corrected(changed[i], brightnesses[b]);
+            }
+            uint32_t actual_ma = 0, expected_ma = 0;
+            std::vector<uint8_t> actual = stream(protocol, (neoled_color_order_t)o, &CORRECTION, brightnesses[b],
+                                                 STRIP_GAMMA, pixels, changed, &actual_ma);
+            std::vector<uint8_t> expected = stream(protocol, (neoled_color_order_t)o, NULL, 255, 1.0f, reference,
+                                                   reference_changed, &expected_ma);
+            CHECK(!actual.empty() && actual == expected);
+            // The estimate applies brightness to the level sum, not to each
+            // channel, so only full brightness compares exactly
+            CHECK(brightnesses[b] != 255 || actual_ma == expected_ma);
+        }
+    }
+}
+
+int main()
+{
+    Host::setRealtime(false);
+
+    srand(5);
+    std::vector<Pixel> pixels(LEDS);
+    std::vector<PixelW> pixels_w(LEDS);
+    for (int i = 0; i < LEDS; i++) {
+        randomPixel(pixels[i]);
+        randomPixel(pixels_w[i]);
+    }
+    pixels[0] = makePixel(255, 255, 255);
+    std::vector<Pixel> changed = pixels;
+    changed[1].red ^= 9;
+    changed[7].blue ^= 77;
+    std::vector<PixelW> changed_w = pixels_w;
+    changed_w[3].white ^= 5;
+    checkStream(NEOLED_WS2812, pixels, changed);
+    checkStream(NEOLED_SK6812_RGBW, pixels_w, changed_w);
+
+    // Identity or NULL correction gives the uncorrected frame back
+    {
+        Strip strip(LEDS);
+        strip.setBackend(Host::captureBackend());
+        strip.setGamma(STRIP_GAMMA);
+        strip.setBrightness(150);
+        CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+        std::vector<std::vector<uint8_t> > plain, sent;
+        Host::resetCapture(0);
+        CHECK(strip.update(pixels.data()) == NEOLED_OK);
+        plain = capturedFrames(0);
+
+        CHECK(strip.setColorCorrection(&CORRECTION) == NEOLED_OK);
+        neoled_color_correction_t read;
+        strip.getColorCorrection(&read);
+        CHECK(memcmp(&read, &CORRECTION, sizeof(read)) == 0);
+        Host::resetCapture(0);
+        CHECK(strip.update(pixels.data()) == NEOLED_OK);
+        CHECK(capturedFrames(0) != plain);
+
+        neoled_color_correction_t identity = {255, 255, 255, 255, 0.0f, 0.0f, 0.0f, 0.0f};
+        CHECK(strip.setColorCorrection(&identity) == NEOLED_OK);
+        Host::resetCapture(0);
+        CHECK(strip.update(pixels.data()) == NEOLED_OK);
+        CHECK(capturedFrames(0) == plain);
+
+        CHECK(strip.setColorCorrection(&CORRECTION) == NEOLED_OK);
+        CHECK(strip.setColorCorrection(NULL) == NEOLED_OK);
+        Host::resetCapture(0);
+        CHECK(strip.update(pixels.data()) == NEOLED_OK);
+        CHECK(capturedFrames(0) == plain);
+
+        neoled_color_correction_t negative = CORRECTION;
+        negative.gamma_blue = -1.0f;
+        CHECK(strip.setColorCorrection(&negative) == NEOLED_ERR_PARAM);
+        strip.getColorCorrection(&read);
+        CHECK(read.green == 255 && read.gamma_green == 0.0f);
+        strip.destroy();
+    }
+
+    // The current estimate counts white balanced levels
+    {
+        std::vector<Pixel> white(100, makePixel(255, 255, 255));
+        Strip strip(100);
+        strip.setBackend(Host::captureBackend());
+        neoled_color_correction_t balance = {255, 176, 240, 255, 0.0f, 0.0f, 0.0f, 0.0f};
+        CHECK(strip.setColorCorrection(&balance) == NEOLED_OK);
+        strip.setPowerLimit(20, 0);
+        CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+        CHECK(strip.update(white.data()) == NEOLED_OK);
+        CHECK(strip.getEstimatedCurrent() == (255 + 176 + 240) * 20 * 100 / 255);
+        strip.destroy();
+    }
+
+#if NEOLED_DITHER
+    // Dithered, the average follows the corrected level before rounding
+    {
+        const int count = 8;
+        const int frames = 256;
+        std::vector<Pixel> levels(count);
+        for (int i = 0; i < count; i++) {
+            levels[i] = makePixel((uint8_t)(20 + i * 30), (uint8_t)(10 + i * 31), (uint8_t)(5 + i * 29));
+        }
+        Strip strip(count);
+        strip.setBackend(Host::captureBackend());
+        strip.setGamma(STRIP_GAMMA);
+        strip.setBrightness(100);
+        CHECK(strip.setDithering(true) == NEOLED_OK);
+        neoled_color_correction_t correction = {255, 176, 240, 255, 0.0f, 2.8f, 0.0f, 0.0f};
+        CHECK(strip.setColorCorrection(&correction) == NEOLED_OK);
+        CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+        Host::resetCapture(0);
+        CHECK(strip.update(levels.data()) == NEOLED_OK);
+        for (int f = 1; f < frames; f++) {
+            CHECK(strip.refresh() == NEOLED_OK);
+        }
+        std::vector<std::vector<uint8_t> > sent = capturedFrames(0);
+        strip.destroy();
+
+        CHECK(sent.size() == (size_t)frames);
+        const float gammas[3] = {2.8f, STRIP_GAMMA, STRIP_GAMMA};  // G, R, B
+        const int scales[3] = {176, 255, 240};
+        double worst = 0.0;
+        for (int i = 0; i < count && sent.size() == (size_t)frames; i++) {
+            uint8_t values[3] = {levels[i].green, levels[i].red, levels[i].blue};
+            for (int c = 0; c < 3; c++) {
+                double sum = 0.0;
+                for (int f = 0; f < frames; f++) {
+                    sum += sent[f][i * 3 + c];
+                }
+                double expected = powf(values[c] / 255.0f, gammas[c]) * 255.0 * scales[c] * 100 / 65025;
+                worst = std::max(worst, fabs(sum / frames - expected));
+            }
+        }
+        CHECK(worst < 0.1);
+    }
+#endif
+
+    return testResult();
+}
@@ -0,0 +1,89 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Dirty tracking test: random sparse changes must send the same bytes as a
+// full re-encode, and getSkippedPixels() must count exactly the unchanged
+// pixels. Built once with NEOLED_DIRTY_TRACKING=0 against the same reference,
+// where every pixel is encoded and none are skipped.
+
+#include <cstring>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+/**
+ * @brief Check the captured write against a full reference encode
+ */
+static bool sentFrame(const std::vector<Pixel>& pixels)
+{
+    std::vector<uint8_t> expected(pixels.size() * 12);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        referenceEncode(pixels[i].green, &expected[i * 12]);
+        referenceEncode(pixels[i].red, &expected[i * 12 + 4]);
+        referenceEncode(pixels[i].blue, &expected[i * 12 + 8]);
+    }
+    std::vector<uint8_t> stream = captured(0);
+    if (stream.size() < expected.size() || memcmp(stream.data(), expected.data(), expected.size()) != 0) {
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    srand(3);
+    Host::setRealtime(false);
+    CHECK(init() == NEOLED_OK);
+
+    std::vector<Pixel> pixels(LED_NUMBER);
+    std::vector<Pixel> shown(LED_NUMBER);
+    for (int frame = 0; frame < 200; frame++) {
+        // Mostly a few changed pixels, sometimes none or a whole new frame
+        int changes = rand() % 8;
+        if (frame % 25 == 0) {
+            changes = LED_NUMBER;
+        }
+        for (int c = 0; c < changes; c++) {
+            int index = changes == LED_NUMBER ? c : rand() % LED_NUMBER;
+            randomPixel(pixels[index]);
+        }
+
+        Host::resetCapture(0);
+        CHECK(update(pixels.data()) == NEOLED_OK);
+        if (!sentFrame(pixels)) {
+            printf("Frame %d differs from a full encode\n", frame);
+            CHECK(false);
+            break;
+        }
+
+        uint16_t unchanged = 0;
+        for (int i = 0; i < LED_NUMBER; i++) {
+            unchanged += memcmp(&pixels[i], &shown[i], sizeof(Pixel)) == 0;
+        }
+        CHECK(getSkippedPixels() == (NEOLED_DIRTY_TRACKING ? unchanged : 0));
+        shown = pixels;
+    }
+
+    destroy();
+    return testResult();
+}
@@ -0,0 +1,234 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Dithering test: the average over 16-step sequences matches the exact
+// level on the undithered gamma curve, dithering enabled after update()
+// carries on the picture on the LEDs, and the render task keeps a static
+// picture's sequence running
+
+#include <cmath>
+#include <thread>
+#include "freertos/task.h"
+#include "host_test.h"
+
+using namespace NeoLED;
+
+static const int LEDS = 60;
+
+static std::vector<Pixel> testPixels(void)
+{
+    std::vector<Pixel> pixels(LEDS);
+    for (int i = 0; i < LEDS; i++) {
+        pixels[i] = makePixel((uint8_t)(255 - i * 4), (uint8_t)(i * 4), (uint8_t)(i * 37));
+    }
+    return pixels;
+}
+
+/**
+ * @brief The frame the LEDs show for pixels at full brightness, gamma 1.0
+ */
+static std::vector<uint8_t> channels(const std::vector<Pixel>& pixels)
+{
+    std::vector<uint8_t> out;
+    for (size_t i = 0; i < pixels.size(); i++) {
+        out.push_back(pixels[i].green);
+        out.push_back(pixels[i].red);
+        out.push_back(pixels[i].blue);
+    }
+    return out;
+}
+
+static std::vector<uint8_t> lastFrame(void)
+{
+    std::vector<std::vector<uint8_t> > frames = capturedFrames(0);
+    Host::resetCapture(0);
+    return frames.empty() ? std::vector<uint8_t>() : frames.back();
+}
+
+static void checkAverage(void)
+{
+    // Gamma 2.2 uses a table, which dithering must follow as well
+    std::vector<uint8_t> curve = gammaCurve(2.2f);
+    std::vector<Pixel> pixels = testPixels();
+    Strip strip(LEDS);
+    strip.setBackend(Host::captureBackend());
+    CHECK(strip.setDithering(true) == NEOLED_OK);
+    CHECK(strip.initWithPin(21, 0) == NEOLED_OK);
+    strip.setBrightness(20);
+    strip.setGamma(2.2f);
+
+    const int frames = 64;
+    std::vector<double> sum(LEDS * 3, 0.0);
+    for (int f = 0; f < frames; f++) {
+        Host::resetCapture(0);
+        CHECK((f == 0 ? strip.update(pixels.data()) : strip.refresh()) == NEOLED_OK);
+        std::vector<uint8_t> frame = lastFrame();
+        CHECK(frame.size() == LEDS * 3);
+        for (size_t i = 0; i < frame.size() && i < sum.size(); i++) {
+            sum[i] += frame[i];
+        }
+    }
+
+    std::vector<uint8_t> values = channels(pixels);
+    double worst = 0.0;
+    for (int i = 0; i < LEDS * 3; i++) {
+        double exact = curve[values[i]] * 20.0 / 255.0;
+        worst = std::max(worst, fabs(sum[i] / frames - exact));
+    }
+    printf("dithered average within %.4f of a level\n", worst);
+    CHECK(worst < 0.05);
+
+    strip.destroy();
+}
+
+static void checkEnableAfterUpdate(void)
+{
+    std::vector<Pixel> pixels = testPixels();
+    std::vector<uint8_t> expected = channels(pixels);
+
+    Strip strip(LEDS);
+    strip.setBackend(Host::captureBackend());
+    CHECK(strip.initWithPin(21, 0) == NEOLED_OK);
+    CHECK(strip.update(pixels.data()) == NEOLED_OK);
+    Host::resetCapture(0);
+
+    // At full brightness and gamma 1.0 every step shows the exact picture
+    CHECK(strip.setDithering(true) == NEOLED_OK);
+#if NEOLED_DIRTY_TRACKING
+    CHECK(strip.refresh() == NEOLED_OK);
+    CHECK(lastFrame() == expected);
+#else
+    CHECK(strip.refresh() == NEOLED_ERR_PARAM);
+    CHECK(Host::writeCount(0) == 0);
+#endif
+
+    CHECK(strip.update(pixels.data()) == NEOLED_OK);
+    CHECK(strip.refresh() == NEOLED_OK);
+    CHECK(lastFrame() == expected);
+
+    // Off and on again without a frame in between
+    CHECK(strip.setDithering(false) == NEOLED_OK);
+    CHECK(strip.setDithering(true) == NEOLED_OK);
+#if NEOLED_DIRTY_TRACKING
+    CHECK(strip.refresh() == NEOLED_OK);
+    CHECK(lastFrame() == expected);
+#endif
+
+    // A frame sent with dithering off is the one dithering carries on
+    std::vector<Pixel> other(LEDS, makePixel(1, 2, 3));
+    CHECK(strip.setDithering(false) == NEOLED_OK);
+    CHECK(strip.update(other.data()) == NEOLED_OK);
+    CHECK(strip.setDithering(true) == NEOLED_OK);
+#if NEOLED_DIRTY_TRACKING
+    CHECK(strip.refresh() == NEOLED_OK);
+    CHECK(lastFrame() == channels(other));
+#endif
+
+    strip.destroy();
+}
+
+static void checkRenderRefresh(void)
+{
+    std::vector<Pixel> pixels = testPixels();
+
+    Strip strip(LEDS);
+    strip.setBackend(Host::captureBackend());
+    CHECK(strip.setDithering(true) == NEOLED_OK);
+    CHECK(strip.setDitherRefresh(5) == NEOLED_OK);
+    CHECK(strip.getDitherRefresh() == 5);
+    CHECK(strip.initWithPin(21, 0) == NEOLED_OK);
+    strip.setBrightness(20);
+    strip.setGamma(2.2f);
+
+    CHECK(strip.startRender(tskNO_AFFINITY) == NEOLED_OK);
+    CHECK(strip.setDitherRefresh(10) == NEOLED_ERR_PARAM);
+    Host::resetCapture(0);
+
+    Pixel* frame = strip.acquireFrame();
+    CHECK(frame != NULL);
+    if (frame != NULL) {
+        for (int i = 0; i < LEDS; i++) {
+            frame[i] = pixels[i];
+        }
+        CHECK(strip.submitFrame() == NEOLED_OK);
+    }
+
+    // One frame submitted; the task keeps sending it with the next step
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CHECK(strip.stopRender() == NEOLED_OK);
+
+    std::vector<std::vector<uint8_t> > frames = capturedFrames(0);
+    printf("render task sent %u frames for one submitted\n", (unsigned)frames.size());
+    CHECK(frames.size() >= 8);
+
+    // Successive frames differ only by the dither rounding
+    bool close = true;
+    bool changed = false;
+    for (size_t f = 1; f < frames.size(); f++) {
+        close = close && frames[f].size() == LEDS * 3;
+        for (size_t i = 0; close && i < frames[f].size(); i++) {
+            close = abs(frames[f][i] - frames[0][i]) <= 1;
+            changed = changed || frames[f][i] != frames[0][i];
+        }
+    }
+    CHECK(close);
+    CHECK(changed);
+
+    strip.destroy();
+}
+
+static void checkRgbw(void)
+{
+    Strip strip(4);
+    strip.setBackend(Host::captureBackend());
+    CHECK(strip.setProtocol(NEOLED_SK6812_RGBW) == NEOLED_OK);
+    CHECK(strip.setDithering(true) == NEOLED_OK);
+    CHECK(strip.initWithPin(21, 0) == NEOLED_OK);
+    strip.setBrightness(3);
+
+    PixelW pixels[4] = {};
+    pixels[0].white = 200;
+    double sum = 0.0;
+    for (int f = 0; f < 16; f++) {
+        Host::resetCapture(0);
+        CHECK((f == 0 ? strip.update(pixels) : strip.refresh()) == NEOLED_OK);
+        std::vector<uint8_t> frame = lastFrame();
+        CHECK(frame.size() == 16);
+        sum += frame.size() == 16 ? frame[3] : 0;
+    }
+    CHECK(fabs(sum / 16 - 200 * 3 / 255.0) < 0.07);
+
+    strip.destroy();
+}
+
+int main()
+{
+    Host::setRealtime(false);
+
+    checkAverage();
+    checkEnableAfterUpdate();
+    checkRenderRefresh();
+    checkRgbw();
+
+    return testResult();
+}
@@ -0,0 +1,132 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// DMA test: every frame must be one write ending in exactly the protocol's
+// reset time of zero samples, and getDmaInfo() must report the fewest
+// descriptors of at most NEOLED_DMA_DESC_BYTES that hold the frame (capped
+// by NEOLED_DMA_DESC_NUM_MAX), balanced to equal length. Built at several
+// LED counts, reset times and descriptor caps.
+
+#include <algorithm>
+#include <cmath>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+/**
+ * @brief Check a DMA layout against the frame it has to hold
+ */
+static void checkLayout(const neoled_dma_info_t& info, size_t frame_bytes)
+{
+    const uint32_t desc_limit = NEOLED_DMA_DESC_BYTES / 4 * 4;  // Whole 4-byte samples
+    uint32_t needed = (uint32_t)((frame_bytes + desc_limit - 1) / desc_limit);
+    uint32_t desc_num = needed;
+    if (NEOLED_DMA_DESC_NUM_MAX > 0) {
+        desc_num = std::min(desc_num, (uint32_t)NEOLED_DMA_DESC_NUM_MAX);
+    }
+    desc_num = std::max(desc_num, 2u);
+    uint32_t samples = (uint32_t)((frame_bytes + 3) / 4);
+    uint32_t desc_bytes = std::min(std::max((samples + desc_num - 1) / desc_num, 8u) * 4, desc_limit);
+
+    CHECK(info.desc_num == desc_num);
+    CHECK(info.desc_bytes == desc_bytes);
+    CHECK(info.total_bytes == (size_t)info.desc_num * info.desc_bytes);
+    if (desc_num >= needed) {
+        CHECK(info.total_bytes >= frame_bytes);
+    }
+    if (info.desc_num != desc_num || info.desc_bytes != desc_bytes) {
+        printf("%u-byte frame: %u x %u bytes, expected %u x %u\n", (unsigned)frame_bytes, (unsigned)info.desc_num,
+               (unsigned)info.desc_bytes, (unsigned)desc_num, (unsigned)desc_bytes);
+    }
+}
+
+/**
+ * @brief Check a captured frame: count LEDs of the slot pattern one, then
+ *        exactly reset_bytes zero bytes, in a single write
+ * @param one Byte a 1 bit pair encodes to (0xEE for three high slots, 0xCC for two)
+ */
+static void checkFrame(int port, uint16_t count, size_t pixel_bytes, size_t reset_bytes, uint8_t one)
+{
+    std::vector<uint8_t> stream = captured(port);
+    CHECK(Host::writeCount(port) == 1);
+    CHECK(stream.size() == count * pixel_bytes + reset_bytes);
+    size_t wrong = 0;
+    for (size_t i = 0; i < stream.size(); i++) {
+        wrong += stream[i] != (i < count * pixel_bytes ? one : 0);
+    }
+    CHECK(wrong == 0);
+}
+
+int main()
+{
+    Host::setRealtime(false);
+
+    // The reset is NEOLED_RESET_US of samples at SAMPLE_RATE, rounded up
+    size_t reset_samples = (size_t)ceil(NEOLED_RESET_US * (double)SAMPLE_RATE / 1e6 - 1e-9);
+    CHECK(ZERO_BUFFER == (int)(reset_samples * 4));
+    CHECK(reset_samples * 1e6 / SAMPLE_RATE >= NEOLED_RESET_US);
+
+    CHECK(init() == NEOLED_OK);
+    std::vector<Pixel> white(LED_NUMBER, makePixel(255, 255, 255));
+    Host::resetCapture(0);
+    CHECK(update(white.data()) == NEOLED_OK);
+    checkFrame(0, LED_NUMBER, PIXEL_SIZE, ZERO_BUFFER, 0xEE);
+
+    neoled_dma_info_t info;
+    CHECK(getDmaInfo(&info) == NEOLED_OK);
+    checkLayout(info, (size_t)LED_NUMBER * PIXEL_SIZE + ZERO_BUFFER);
+    destroy();
+    CHECK(getDmaInfo(&info) == NEOLED_ERR_NOT_INIT);
+
+    // Each protocol's reset and slot pattern, at several strip lengths
+    struct ProtocolCase {
+        neoled_protocol_t protocol;
+        size_t reset_bytes;
+        uint8_t one;
+    };
+    const ProtocolCase protocols[5] = {
+        {NEOLED_WS2812, (size_t)ZERO_BUFFER, 0xEE},
+        {NEOLED_SK6812, 32, 0xCC},   // 80 us at 100 kHz
+        {NEOLED_WS2811, 60, 0xCC},   // 300 us at 50 kHz
+        {NEOLED_WS2815, 112, 0xEE},  // 280 us at 100 kHz
+        {NEOLED_APA106, 16, 0xEE},   // 50 us at 73 kHz, rounded up
+    };
+    const uint16_t counts[4] = {1, 100, 340, 1000};
+    for (int p = 0; p < 5; p++) {
+        for (int c = 0; c < 4; c++) {
+            Strip strip(counts[c]);
+            strip.setBackend(Host::captureBackend());
+            strip.setProtocol(protocols[p].protocol);
+            CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+            std::vector<Pixel> pixels(counts[c], makePixel(255, 255, 255));
+            Host::resetCapture(0);
+            CHECK(strip.update(pixels.data()) == NEOLED_OK);
+            checkFrame(0, counts[c], PIXEL_SIZE, protocols[p].reset_bytes, protocols[p].one);
+            CHECK(strip.getDmaInfo(&info) == NEOLED_OK);
+            checkLayout(info, (size_t)counts[c] * PIXEL_SIZE + protocols[p].reset_bytes);
+            strip.destroy();
+        }
+    }
+
+    return testResult();
+}
@@ -0,0 +1,193 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Encoded framebuffer test: setPixel() and show() put the same frames on the
+// LEDs as update() with the equivalent Pixel array, and the settings the
+// encoding depends on stay fixed while the mode is on
+
+#include <cstdlib>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+/**
+ * @brief Run a random sequence of edits and record what the LEDs show after each
+ * @param encoded true to set LEDs in encoded framebuffer mode, false to
+ *        update() the whole array instead
+ */
+template <typename P>
+static std::vector<std::vector<uint8_t> > run(bool encoded, neoled_protocol_t protocol, bool prefix,
+                                              unsigned seed, int count)
+{
+    srand(seed);
+    std::vector<std::vector<uint8_t> > shown;
+    captureStrip(
+        count, Host::captureBackend(),
+        [&](Strip& strip) {
+            strip.setProtocol(protocol);
+            strip.setAutoPrefix(prefix);
+            strip.setBrightness(180);
+            strip.setGamma(2.2f);
+            if (encoded) {
+                CHECK(strip.setEncodedFramebuffer(true) == NEOLED_OK);
+            }
+        },
+        [&](Strip& strip) {
+            std::vector<uint8_t> leds(count * sizeof(P));
+            latchCapture(leds);
+            std::vector<P> mirror(count, P()), other(count);
+            for (int step = 0; step < 300; step++) {
+                int op = rand() % 16;
+                if (op < 10) {
+                    int edits = 1 + rand() % 3;
+                    for (int j = 0; j < edits; j++) {
+                        int index = rand() % count;
+                        P pixel;
+                        randomPixel(pixel);
+                        if (rand() % 4 == 0) {
+                            pixel = mirror[index];
+                        }
+                        mirror[index] = pixel;
+                        if (encoded) {
+                            CHECK(strip.setPixel(index, pixel) == NEOLED_OK);
+                        }
+                    }
+                    continue;
+                } else if (op < 14) {
+                    CHECK((encoded ? strip.show() : strip.update(mirror.data())) == NEOLED_OK);
+                } else if (op == 14) {
+                    for (size_t i = 0; i < other.size(); i++) {
+                        randomPixel(other[i]);
+                    }
+                    mirror = other;
+                    CHECK(strip.update(other.data()) == NEOLED_OK);
+                } else {
+                    mirror.assign(count, P());
+                    CHECK(strip.clear() == NEOLED_OK);
+                }
+                latchCapture(leds);
+                shown.push_back(leds);
+            }
+        });
+    return shown;
+}
+
+int main()
+{
+    Host::setRealtime(false);
+
+    for (unsigned seed = 1; seed <= 4; seed++) {
+        for (int prefix = 0; prefix < 2; prefix++) {
+            CHECK(run<Pixel>(true, NEOLED_WS2812, prefix, seed, 57) ==
+                  run<Pixel>(false, NEOLED_WS2812, prefix, seed, 57));
+            CHECK(run<PixelW>(true, NEOLED_SK6812_RGBW, prefix, seed, 23) ==
+                  run<PixelW>(false, NEOLED_SK6812_RGBW, prefix, seed, 23));
+        }
+    }
+
+    // The encoding is fixed while the mode is on, so every LED of a frame
+    // is encoded alike
+    {
+        Strip strip(4);
+        strip.setBackend(Host::captureBackend());
+        strip.setBrightness(128);
+        strip.setPowerLimit(20, 100);
+        CHECK(strip.setEncodedFramebuffer(true) == NEOLED_ERR_PARAM);
+        strip.setPowerLimit(20, 0);
+        CHECK(strip.setEncodedFramebuffer(true) == NEOLED_OK);
+        CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+
+        Pixel white = makePixel(255, 255, 255);
+        CHECK(strip.setPixel(0, white) == NEOLED_OK);
+        strip.setBrightness(32);
+        strip.setGamma(2.2f);
+        strip.setPowerLimit(20, 10);
+        neoled_color_correction_t correction = {255, 128, 255, 255, 0.0f, 0.0f, 0.0f, 0.0f};
+        CHECK(strip.setColorCorrection(&correction) == NEOLED_ERR_PARAM);
+        CHECK(strip.getBrightness() == 128);
+        CHECK(strip.getGamma() == 1.0f);
+        CHECK(strip.getPowerLimit() == 0);
+        CHECK(strip.setPixel(1, white) == NEOLED_OK);
+
+        Host::resetCapture(0);
+        CHECK(strip.show() == NEOLED_OK);
+        std::vector<std::vector<uint8_t> > frames = capturedFrames(0);
+        CHECK(frames.size() == 1 && frames[0].size() == 12);
+        if (frames.size() == 1 && frames[0].size() == 12) {
+            for (int i = 0; i < 6; i++) {
+                CHECK(frames[0][i] == 128);
+            }
+        }
+
+        CHECK(strip.setEncodedFramebuffer(false) == NEOLED_OK);
+        strip.setBrightness(32);
+        CHECK(strip.getBrightness() == 32);
+        strip.destroy();
+    }
+
+    // Calls the mode cannot serve are refused
+    {
+        Strip strip(8);
+        strip.setBackend(Host::captureBackend());
+        CHECK(strip.setEncodedFramebuffer(true) == NEOLED_OK);
+        Pixel pixel = makePixel(1, 2, 3);
+        CHECK(strip.setPixel(0, pixel) == NEOLED_ERR_NOT_INIT);
+        CHECK(strip.getPixels() == NULL);
+        CHECK(strip.setStreaming(4) == NEOLED_ERR_PARAM);
+#if NEOLED_DITHER
+        CHECK(strip.setDithering(true) == NEOLED_ERR_PARAM);
+#endif
+        CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+        CHECK(strip.setPixel(8, pixel) == NEOLED_ERR_PARAM);
+        CHECK(strip.setPixel(7, pixel) == NEOLED_OK);
+#if NEOLED_ASYNC
+        CHECK(strip.showAsync() == NEOLED_ERR_PARAM);
+        CHECK(strip.updateAsync(&pixel) == NEOLED_ERR_PARAM);
+#endif
+        CHECK(strip.show() == NEOLED_OK);
+        strip.destroy();
+        CHECK(strip.setEncodedFramebuffer(false) == NEOLED_OK);
+        CHECK(strip.getPixels() != NULL);
+    }
+
+#if NEOLED_DIRTY_TRACKING
+    // The current estimate follows the LEDs set
+    {
+        Strip strip(100);
+        strip.setBackend(Host::captureBackend());
+        strip.setEncodedFramebuffer(true);
+        CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+        std::vector<Pixel> pixels(100, makePixel(255, 255, 255));
+        CHECK(strip.update(pixels.data()) == NEOLED_OK);
+        uint32_t full = strip.getEstimatedCurrent();
+        for (int i = 0; i < 50; i++) {
+            strip.setPixel(i, makePixel(0, 0, 0));
+        }
+        CHECK(strip.show() == NEOLED_OK);
+        CHECK(strip.getEstimatedCurrent() == full / 2);
+        strip.destroy();
+    }
+#endif
+
+    return testResult();
+}
@@ -0,0 +1,76 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Encoder test: the captured I2S stream must match a bit-by-bit reference
+// encoder byte-for-byte for every colour value. Built once per encoder
+// (NEOLED_ENCODER_LUT=1 and 0) with LED_NUMBER=256.
+
+#include <cstring>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+int main()
+{
+    Host::setRealtime(false);
+    CHECK(init() == NEOLED_OK);
+    Host::resetCapture(0);
+
+    // Every value appears in every channel
+    std::vector<Pixel> pixels(LED_NUMBER);
+    for (int i = 0; i < LED_NUMBER; i++) {
+        pixels[i].red = (uint8_t)i;
+        pixels[i].green = (uint8_t)(255 - i);
+        pixels[i].blue = (uint8_t)(i * 7);
+    }
+    CHECK(update(pixels.data()) == NEOLED_OK);
+
+    std::vector<uint8_t> expected(LED_NUMBER * PIXEL_SIZE);
+    for (int i = 0; i < LED_NUMBER; i++) {
+        referenceEncode(pixels[i].green, &expected[i * PIXEL_SIZE]);
+        referenceEncode(pixels[i].red, &expected[i * PIXEL_SIZE + 4]);
+        referenceEncode(pixels[i].blue, &expected[i * PIXEL_SIZE + 8]);
+    }
+
+    std::vector<uint8_t> stream = captured(0);
+    CHECK(stream.size() > expected.size());
+    if (stream.size() > expected.size()) {
+        CHECK(memcmp(stream.data(), expected.data(), expected.size()) == 0);
+        for (size_t i = 0; i < expected.size(); i++) {
+            if (stream[i] != expected[i]) {
+                printf("LED %d byte %d: 0x%02x, expected 0x%02x\n", (int)(i / PIXEL_SIZE), (int)(i % PIXEL_SIZE),
+                       stream[i], expected[i]);
+                break;
+            }
+        }
+        // The rest is the reset
+        bool reset = true;
+        for (size_t i = expected.size(); i < stream.size(); i++) {
+            reset = reset && stream[i] == 0;
+        }
+        CHECK(reset);
+    }
+
+    destroy();
+    return testResult();
+}
@@ -0,0 +1,133 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Fill test: fill() sends the same stream as update() with every LED set to
+// the colour, on every backend and colour pipeline, and clear() leaves dirty
+// tracking in step with the LEDs
+
+#include <cstdlib>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+struct Options {
+    const neoled_backend_t* backend;
+    neoled_protocol_t protocol;
+    neoled_color_order_t order;
+    bool correction;
+    uint32_t limit_ma;
+    bool dithering;
+    uint16_t stream_leds;
+};
+
+/**
+ * @brief Everything a strip sends from init() to destroy() for two frames
+ *        of one colour
+ * @param use_fill true to send them with fill(), false with update()
+ */
+static std::vector<uint8_t> stream(const Options& options, bool use_fill, const Pixel& colour, int count)
+{
+    return captureStrip(
+        count, options.backend,
+        [&](Strip& strip) {
+            strip.setProtocol(options.protocol);
+            strip.setColorOrder(options.order);
+            strip.setBrightness(170);
+            strip.setGamma(2.2f);
+            if (options.correction) {
+                neoled_color_correction_t correction = {255, 200, 150, 100, 0.0f, 1.8f, 0.0f, 2.4f};
+                CHECK(strip.setColorCorrection(&correction) == NEOLED_OK);
+            }
+            if (options.limit_ma != 0) {
+                strip.setPowerLimit(20, options.limit_ma);
+            }
+#if NEOLED_DITHER
+            if (options.dithering) {
+                CHECK(strip.setDithering(true) == NEOLED_OK);
+            }
+#endif
+            if (options.stream_leds != 0) {
+                CHECK(strip.setStreaming(options.stream_leds) == NEOLED_OK);
+            }
+        },
+        [&](Strip& strip) {
+            std::vector<Pixel> pixels(count, colour);
+            for (int f = 0; f < 2; f++) {
+                CHECK((use_fill ? strip.fill(colour) : strip.update(pixels.data())) == NEOLED_OK);
+            }
+        });
+}
+
+int main()
+{
+    Host::setRealtime(false);
+    srand(7);
+
+    const neoled_backend_t* backends[3] = {Host::captureBackend(), rmtBackend(), spiBackend()};
+    const neoled_protocol_t protocols[5] = {NEOLED_WS2812, NEOLED_WS2811, NEOLED_SK6812_RGBW, NEOLED_WS2815,
+                                            NEOLED_APA106};
+    const neoled_color_order_t orders[3] = {NEOLED_ORDER_RGB, NEOLED_ORDER_GRB, NEOLED_ORDER_BGR};
+    const uint32_t limits[2] = {0, 300};
+    const uint16_t chunks[2] = {0, 7};
+    const int counts[4] = {1, 2, 3, 37};
+    for (int b = 0; b < 3; b++) {
+        for (int p = 0; p < 5; p++) {
+            for (int o = 0; o < 3; o++) {
+                for (int mask = 0; mask < 16; mask++) {
+                    Options options = {backends[b], protocols[p], orders[o], (mask & 1) != 0, limits[(mask >> 1) & 1],
+                                       (mask & 4) != 0, chunks[(mask >> 3) & 1]};
+                    // Streaming needs a ring backend and whole frames for dithering
+                    if (options.stream_leds != 0 && (options.backend == rmtBackend() || options.dithering)) {
+                        continue;
+                    }
+                    for (int n = 0; n < 4; n++) {
+                        Pixel colour;
+                        randomPixel(colour);
+                        std::vector<uint8_t> filled = stream(options, true, colour, counts[n]);
+                        CHECK(!filled.empty() && filled == stream(options, false, colour, counts[n]));
+                    }
+                }
+            }
+        }
+    }
+
+    // After clear() dirty tracking compares with the LEDs off, so the same
+    // frame again re-encodes only what is lit
+#if NEOLED_DIRTY_TRACKING
+    {
+        Strip strip(50);
+        strip.setBackend(Host::captureBackend());
+        strip.setAutoPrefix(true);
+        CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+        std::vector<Pixel> pixels(50, COLOR_OFF);
+        pixels[3] = makePixel(2, 1, 3);
+        CHECK(strip.update(pixels.data()) == NEOLED_OK);
+        CHECK(strip.clear() == NEOLED_OK);
+        CHECK(strip.update(pixels.data()) == NEOLED_OK);
+        CHECK(strip.getSkippedPixels() == 49);
+        strip.destroy();
+    }
+#endif
+
+    return testResult();
+}
@@ -0,0 +1,153 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Framebuffer test: setPixel() and show() send the same stream as update()
+// with an equivalent Pixel array, through any mix of settings changes, other
+// updates and queued frames, and so does drawing through getPixels()
+
+#include <cstdlib>
+#include <cstring>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+/**
+ * @brief Everything a strip sends for a random sequence of operations
+ * @param framebuffer true to set LEDs in the framebuffer and show() it,
+ *        false to update() a copy kept by the test instead
+ */
+template <typename P>
+static std::vector<uint8_t> run(bool framebuffer, neoled_protocol_t protocol, bool prefix, unsigned seed, int count)
+{
+    srand(seed);
+    return captureStrip(
+        count, Host::captureBackend(),
+        [&](Strip& strip) {
+            strip.setProtocol(protocol);
+            strip.setAutoPrefix(prefix);
+        },
+        [&](Strip& strip) {
+            std::vector<P> mirror(count, P()), other(count);
+            for (int step = 0; step < 400; step++) {
+                int op = rand() % 20;
+                if (op < 10) {
+                    int edits = 1 + rand() % 3;
+                    for (int j = 0; j < edits; j++) {
+                        int index = rand() % count;
+                        randomPixel(mirror[index]);
+                        if (framebuffer) {
+                            CHECK(strip.setPixel(index, mirror[index]) == NEOLED_OK);
+                        }
+                    }
+                } else if (op < 14) {
+                    CHECK((framebuffer ? strip.show() : strip.update(mirror.data())) == NEOLED_OK);
+                } else if (op < 16) {
+#if NEOLED_ASYNC
+                    CHECK((framebuffer ? strip.showAsync() : strip.updateAsync(mirror.data())) == NEOLED_OK);
+#else
+                    CHECK((framebuffer ? strip.show() : strip.update(mirror.data())) == NEOLED_OK);
+#endif
+                } else if (op == 16) {
+                    strip.setBrightness((uint8_t)rand());
+                } else if (op == 17) {
+                    strip.setPowerLimit(20, (rand() & 1) ? 200 + rand() % 2000 : 0);
+                } else if (op == 18) {
+                    // Another array leaves the framebuffer for the next show()
+                    for (int i = 0; i < count; i++) {
+                        randomPixel(other[i]);
+                    }
+                    CHECK(strip.update(other.data()) == NEOLED_OK);
+                } else if (rand() & 1) {
+                    CHECK(strip.clear() == NEOLED_OK);
+                } else {
+                    strip.setGamma((rand() & 1) ? 1.0f : 2.2f);
+                }
+            }
+        });
+}
+
+int main()
+{
+    Host::setRealtime(false);
+
+    for (unsigned seed = 1; seed <= 6; seed++) {
+        for (int prefix = 0; prefix < 2; prefix++) {
+            std::vector<uint8_t> shown = run<Pixel>(true, NEOLED_WS2812, prefix, seed, 61);
+            CHECK(!shown.empty() && shown == run<Pixel>(false, NEOLED_WS2812, prefix, seed, 61));
+            std::vector<uint8_t> shown_w = run<PixelW>(true, NEOLED_SK6812_RGBW, prefix, seed, 29);
+            CHECK(!shown_w.empty() && shown_w == run<PixelW>(false, NEOLED_SK6812_RGBW, prefix, seed, 29));
+        }
+    }
+
+    // Frames drawn through getPixels() are compared whole on every show()
+    {
+        const int count = 40;
+        srand(5);
+        std::vector<std::vector<Pixel> > frames(15, std::vector<Pixel>(count));
+        for (size_t f = 0; f < frames.size(); f++) {
+            for (int i = 0; i < count; i++) {
+                if (rand() & 1) {
+                    randomPixel(frames[f][i]);
+                }
+            }
+        }
+        std::vector<uint8_t> streams[2];
+        for (int m = 0; m < 2; m++) {
+            streams[m] = captureStrip(count, Host::captureBackend(), [](Strip&) {}, [&](Strip& strip) {
+                for (size_t f = 0; f < frames.size(); f++) {
+                    if (m == 0) {
+                        memcpy(strip.getPixels(), frames[f].data(), sizeof(Pixel) * count);
+                        CHECK(strip.show() == NEOLED_OK);
+                    } else {
+                        CHECK(strip.update(frames[f].data()) == NEOLED_OK);
+                    }
+                }
+            });
+        }
+        CHECK(!streams[0].empty() && streams[0] == streams[1]);
+    }
+
+    // The framebuffer follows the protocol's pixel type
+    {
+        Strip strip(10);
+        strip.setBackend(Host::captureBackend());
+        CHECK(strip.show() == NEOLED_ERR_NOT_INIT);
+        CHECK(strip.getPixelsW() == NULL);
+        Pixel* pixels = strip.getPixels();
+        CHECK(pixels != NULL && strip.getPixels() == pixels);
+        Pixel red = makePixel(255, 0, 0);
+        CHECK(strip.setPixel(10, red) == NEOLED_ERR_PARAM);
+        PixelW white;
+        randomPixel(white);
+        CHECK(strip.setPixel(0, white) == NEOLED_ERR_PARAM);
+
+        CHECK(strip.setProtocol(NEOLED_SK6812_RGBW) == NEOLED_OK);
+        CHECK(strip.getPixels() == NULL);
+        CHECK(strip.getPixelsW() != NULL);
+        CHECK(strip.setPixel(9, makePixel(2, 1, 3)) == NEOLED_OK);
+        CHECK(strip.getPixelsW()[9].red == 2 && strip.getPixelsW()[9].green == 1 &&
+              strip.getPixelsW()[9].blue == 3 && strip.getPixelsW()[9].white == 0);
+    }
+
+    return testResult();
+}
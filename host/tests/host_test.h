@@ -0,0 +1,234 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Shared helpers for the host tests: checks and a reference encoder and
+// decoder for the captured I2S byte stream
+#ifndef NEOLED_HOST_TEST_H
+#define NEOLED_HOST_TEST_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "neoled.h"
+#include "neoled_host.h"
+
+static int test_failures = 0;
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            test_failures++;                                                    \
+        }                                                                       \
+    } while (0)
+
+/**
+ * @brief Print the test outcome
+ * @return Process exit code: 0 if every check passed
+ */
+static inline int testResult(void)
+{
+    if (test_failures != 0) {
+        printf("FAILED (%d)\n", test_failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
+
+/**
+ * @brief Reference WS2812 encoding of one colour byte, one bit at a time
+ * @param value Colour byte
+ * @param out Receives four bytes: two bits each, MSB first, 1000 for a 0 bit
+ *        and 1110 for a 1 bit
+ */
+static inline void referenceEncode(uint8_t value, uint8_t* out)
+{
+    for (int i = 0; i < 4; i++) {
+        uint8_t high = (value >> (7 - 2 * i)) & 1;
+        uint8_t low = (value >> (6 - 2 * i)) & 1;
+        out[i] = (uint8_t)((high ? 0xe0 : 0x80) | (low ? 0x0e : 0x08));
+    }
+}
+
+/**
+ * @brief Decode one colour byte from four captured I2S bytes
+ * @note A bit is 1 when more than one of its four slots is high, so this
+ *       also reads protocols with other slot counts
+ */
+static inline uint8_t decodeByte(const uint8_t* in)
+{
+    uint8_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        uint8_t high = in[i] >> 4;
+        uint8_t low = in[i] & 0x0f;
+        value = (uint8_t)(value << 2 | (__builtin_popcount(high) > 1) << 1 | (__builtin_popcount(low) > 1));
+    }
+    return value;
+}
+
+/**
+ * @brief Bytes written to a port since the last resetCapture()
+ * @param port I2S port number, PARALLEL_PORT, RMT_PORT or SPI_PORT
+ */
+static inline std::vector<uint8_t> captured(int port)
+{
+    size_t size = 0;
+    const uint8_t* data = NeoLED::Host::captureData(port, &size);
+    return std::vector<uint8_t>(data, data + size);
+}
+
+/**
+ * @brief Split a captured stream into frames
+ * @return The decoded channel bytes of each write, in wire order
+ * @note Encoded pixel bytes are never zero and reset bytes always are
+ */
+static inline std::vector<std::vector<uint8_t> > capturedFrames(int port)
+{
+    size_t size = 0;
+    const uint8_t* data = NeoLED::Host::captureData(port, &size);
+    std::vector<std::vector<uint8_t> > frames;
+    size_t i = 0;
+    while (i < size) {
+        while (i < size && data[i] == 0) {
+            i++;
+        }
+        if (i == size) {
+            break;
+        }
+        std::vector<uint8_t> frame;
+        while (i + 4 <= size && data[i] != 0) {
+            frame.push_back(decodeByte(&data[i]));
+            i += 4;
+        }
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+/**
+ * @brief Replay captured writes onto simulated LEDs, then reset the capture
+ * @param leds Channel bytes latched by the strip; each write overwrites
+ *        its leading bytes, like a shorter frame does on real LEDs
+ */
+static inline void latchCapture(std::vector<uint8_t>& leds, int port = 0)
+{
+    std::vector<std::vector<uint8_t> > frames = capturedFrames(port);
+    for (size_t f = 0; f < frames.size(); f++) {
+        for (size_t i = 0; i < frames[f].size() && i < leds.size(); i++) {
+            leds[i] = frames[f][i];
+        }
+    }
+    NeoLED::Host::resetCapture(port);
+}
+
+/**
+ * @brief Random pixel from rand(), so a seed replays the same sequence
+ */
+static inline void randomPixel(NeoLED::Pixel& pixel)
+{
+    pixel = NeoLED::makePixel((uint8_t)rand(), (uint8_t)rand(), (uint8_t)rand());
+}
+
+static inline void randomPixel(NeoLED::PixelW& pixel)
+{
+    pixel.red = (uint8_t)rand();
+    pixel.green = (uint8_t)rand();
+    pixel.blue = (uint8_t)rand();
+    pixel.white = (uint8_t)rand();
+}
+
+#if NEOLED_PIXEL16
+static inline void randomPixel(NeoLED::Pixel16& pixel)
+{
+    pixel.red = (uint16_t)rand();
+    pixel.green = (uint16_t)rand();
+    pixel.blue = (uint16_t)rand();
+}
+#endif
+
+/**
+ * @brief Port a backend's output is captured on
+ * @param backend Capture (I2S port 0), RMT or SPI backend
+ */
+static inline int capturePort(const NeoLED::neoled_backend_t* backend)
+{
+    return backend == NeoLED::rmtBackend() ? NeoLED::Host::RMT_PORT
+         : backend == NeoLED::spiBackend() ? NeoLED::Host::SPI_PORT : 0;
+}
+
+/**
+ * @brief Everything a strip sends from init() to destroy()
+ * @param count Number of LEDs
+ * @param backend Backend, captured on capturePort()
+ * @param setup Called with the strip before init(), to apply settings
+ * @param body Called with the initialized strip, to send frames
+ * @note The SPI queue may hold frames until destroy(), so streams are only
+ *       comparable whole
+ */
+template <typename Setup, typename Body>
+static std::vector<uint8_t> captureStrip(uint16_t count, const NeoLED::neoled_backend_t* backend, Setup setup,
+                                         Body body)
+{
+    NeoLED::Strip strip(count);
+    strip.setBackend(backend);
+    setup(strip);
+    int port = capturePort(backend);
+    NeoLED::Host::resetCapture(port);
+    CHECK(strip.initWithPin(18, backend == NeoLED::spiBackend() ? 2 : 0) == NeoLED::NEOLED_OK);
+    body(strip);
+    strip.destroy();
+    return captured(port);
+}
+
+/**
+ * @brief Level each colour value is sent at with a gamma, at full brightness
+ *        and without dithering: the curve every path must follow
+ * @param gamma Strip gamma
+ * @param port Capture port the strip borrows (its capture is discarded)
+ */
+static inline std::vector<uint8_t> gammaCurve(float gamma, int port = 0)
+{
+    std::vector<NeoLED::Pixel> pixels(256);
+    for (int value = 0; value < 256; value++) {
+        pixels[value] = NeoLED::makePixel((uint8_t)value, (uint8_t)value, (uint8_t)value);
+    }
+    NeoLED::Strip strip(256);
+    strip.setBackend(NeoLED::Host::captureBackend());
+    strip.initWithPin(21, port);
+    strip.setGamma(gamma);
+    NeoLED::Host::resetCapture(port);
+    strip.update(pixels.data());
+
+    std::vector<uint8_t> curve(256, 0);
+    std::vector<std::vector<uint8_t> > frames = capturedFrames(port);
+    for (int value = 0; value < 256 && !frames.empty() && frames[0].size() == 256 * 3; value++) {
+        curve[value] = frames[0][value * 3];
+    }
+    strip.destroy();
+    NeoLED::Host::resetCapture(port);
+    return curve;
+}
+
+#endif // NEOLED_HOST_TEST_H
@@ -0,0 +1,141 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Colour order test: every order puts the channels on the wire in its own
+// sequence, and on every backend matches GRB fed with pixels swizzled by hand
+
+#include <cstdlib>
+#include <cstring>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+static const int LEDS = 37;
+static const char* const ORDER_NAMES[7] = {NULL, "RGB", "RBG", "GRB", "GBR", "BRG", "BGR"};
+
+template <typename P>
+static uint8_t channel(const P& pixel, char name)
+{
+    return name == 'R' ? pixel.red : name == 'G' ? pixel.green : pixel.blue;
+}
+
+/**
+ * @brief Everything a strip sends for a few updates of the same pixels
+ */
+template <typename P>
+static std::vector<uint8_t> stream(const neoled_backend_t* backend, neoled_protocol_t protocol,
+                                   neoled_color_order_t order, const P* pixels)
+{
+    return captureStrip(
+        LEDS, backend,
+        [&](Strip& strip) {
+            strip.setProtocol(protocol);
+            CHECK(strip.setColorOrder(order) == NEOLED_OK);
+            strip.setBrightness(200);
+            strip.setGamma(2.2f);
+        },
+        [&](Strip& strip) {
+            std::vector<P> changed(pixels, pixels + LEDS);
+            changed[0].red ^= 1;
+            changed[0].green ^= 1;
+            changed[0].blue ^= 1;
+            CHECK(strip.update(pixels) == NEOLED_OK);
+            CHECK(strip.update(pixels) == NEOLED_OK);
+            CHECK(strip.update(changed.data()) == NEOLED_OK);
+            CHECK(strip.update(pixels) == NEOLED_OK);
+        });
+}
+
+int main()
+{
+    Host::setRealtime(false);
+
+    srand(3);
+    std::vector<Pixel> pixels(LEDS);
+    std::vector<PixelW> pixels_w(LEDS);
+    for (int i = 0; i < LEDS; i++) {
+        randomPixel(pixels[i]);
+        randomPixel(pixels_w[i]);
+    }
+
+    const neoled_backend_t* backends[3] = {Host::captureBackend(), rmtBackend(), spiBackend()};
+    for (int o = NEOLED_ORDER_RGB; o <= NEOLED_ORDER_BGR; o++) {
+        neoled_color_order_t order = (neoled_color_order_t)o;
+        const char* name = ORDER_NAMES[o];
+
+        // The wire carries the channels in the order's sequence
+        {
+            Strip strip(LEDS);
+            strip.setBackend(Host::captureBackend());
+            CHECK(strip.setColorOrder(order) == NEOLED_OK);
+            CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+            Host::resetCapture(0);
+            CHECK(strip.update(pixels.data()) == NEOLED_OK);
+            std::vector<std::vector<uint8_t> > frames = capturedFrames(0);
+            CHECK(frames.size() == 1 && frames[0].size() == LEDS * 3);
+            for (int i = 0; frames.size() == 1 && frames[0].size() == LEDS * 3 && i < LEDS; i++) {
+                for (int c = 0; c < 3; c++) {
+                    CHECK(frames[0][i * 3 + c] == channel(pixels[i], name[c]));
+                }
+            }
+            strip.destroy();
+        }
+
+        // GRB is the protocols' native order, so an order must match GRB fed
+        // with pixels that hold the order's channels in the GRB slots
+        std::vector<Pixel> swizzled(LEDS);
+        std::vector<PixelW> swizzled_w(LEDS);
+        for (int i = 0; i < LEDS; i++) {
+            swizzled[i].green = channel(pixels[i], name[0]);
+            swizzled[i].red = channel(pixels[i], name[1]);
+            swizzled[i].blue = channel(pixels[i], name[2]);
+            swizzled_w[i].green = channel(pixels_w[i], name[0]);
+            swizzled_w[i].red = channel(pixels_w[i], name[1]);
+            swizzled_w[i].blue = channel(pixels_w[i], name[2]);
+            swizzled_w[i].white = pixels_w[i].white;
+        }
+        for (int b = 0; b < 3; b++) {
+            const neoled_protocol_t protocols[4] = {NEOLED_WS2812, NEOLED_WS2811, NEOLED_WS2815, NEOLED_APA106};
+            for (int p = 0; p < 4; p++) {
+                std::vector<uint8_t> actual = stream(backends[b], protocols[p], order, pixels.data());
+                std::vector<uint8_t> expected = stream(backends[b], protocols[p], NEOLED_ORDER_GRB, swizzled.data());
+                CHECK(!actual.empty() && actual == expected);
+            }
+            std::vector<uint8_t> actual = stream(backends[b], NEOLED_SK6812_RGBW, order, pixels_w.data());
+            std::vector<uint8_t> expected = stream(backends[b], NEOLED_SK6812_RGBW, NEOLED_ORDER_GRB, swizzled_w.data());
+            CHECK(!actual.empty() && actual == expected);
+        }
+    }
+
+    Strip strip(4);
+    CHECK(strip.getColorOrder() == NEOLED_ORDER_GRB);
+    strip.setProtocol(NEOLED_WS2811);
+    CHECK(strip.getColorOrder() == NEOLED_ORDER_RGB);
+    CHECK(strip.setColorOrder(NEOLED_ORDER_BGR) == NEOLED_OK);
+    CHECK(strip.getColorOrder() == NEOLED_ORDER_BGR);
+    CHECK(strip.setColorOrder((neoled_color_order_t)7) == NEOLED_ERR_PARAM);
+    CHECK(strip.setColorOrder(NEOLED_ORDER_DEFAULT) == NEOLED_OK);
+    CHECK(strip.getColorOrder() == NEOLED_ORDER_RGB);
+
+    return testResult();
+}
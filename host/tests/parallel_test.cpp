@@ -0,0 +1,125 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Parallel encoder test: the transpose kernel must match the bit-by-bit
+// reference for 8 and 16 lanes, and ParallelStrip must send its output
+
+#include <cstdlib>
+#include <cstring>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+/**
+ * @brief Compare encodeParallel() with encodeParallelReference() for one shape
+ */
+static void checkKernel(uint8_t lane_count, uint16_t led_count, unsigned seed)
+{
+    srand(seed);
+    std::vector<std::vector<Pixel> > pixels(16, std::vector<Pixel>(led_count));
+    const Pixel* lanes[16];
+    for (int l = 0; l < 16; l++) {
+        for (int i = 0; i < led_count; i++) {
+            randomPixel(pixels[l][i]);
+        }
+        lanes[l] = pixels[l].data();
+    }
+    lanes[3] = NULL;  // A missing lane sends LEDs off
+    // Bit patterns that catch a transposed or shifted lane
+    pixels[0][0] = makePixel(0xff, 0x00, 0x80);
+    pixels[1][0] = makePixel(0x01, 0xaa, 0x55);
+
+    size_t bytes = parallelFrameBytes(lane_count, led_count);
+    std::vector<uint8_t> expected(bytes, 0x5a);
+    std::vector<uint8_t> actual(bytes, 0xa5);
+    encodeParallelReference(lanes, lane_count, led_count, expected.data());
+    encodeParallel(lanes, lane_count, led_count, actual.data());
+    if (expected != actual) {
+        printf("%u lanes, %u LEDs: kernel differs from reference\n", lane_count, led_count);
+    }
+    CHECK(expected == actual);
+}
+
+#if NEOLED_PARALLEL
+/**
+ * @brief Check the samples ParallelStrip sends for a frame
+ */
+static void checkStrip(uint8_t lane_count)
+{
+    const uint16_t led_count = 50;
+    std::vector<std::vector<Pixel> > pixels(16, std::vector<Pixel>(led_count));
+    const Pixel* lanes[16];
+    for (int l = 0; l < 16; l++) {
+        for (int i = 0; i < led_count; i++) {
+            pixels[l][i] = makePixel((uint8_t)(l * 10 + i), (uint8_t)i, (uint8_t)(255 - i));
+        }
+        lanes[l] = pixels[l].data();
+    }
+
+    int pins[16];
+    for (int i = 0; i < 16; i++) {
+        pins[i] = i + 1;
+    }
+    ParallelStrip strip(lane_count, led_count);
+    CHECK(strip.init(pins, 30) == NEOLED_OK);
+    Host::resetCapture(Host::PARALLEL_PORT);
+    CHECK(strip.update(lanes) == NEOLED_OK);
+    strip.destroy();
+
+    size_t bytes = parallelFrameBytes(lane_count, led_count);
+    std::vector<uint8_t> expected(bytes);
+    encodeParallelReference(lanes, lane_count, led_count, expected.data());
+
+    // The frame, then the all-off frame destroy() sends
+    size_t size = 0;
+    const uint8_t* data = Host::captureData(Host::PARALLEL_PORT, &size);
+    size_t frame = size / 2;
+    CHECK(Host::writeCount(Host::PARALLEL_PORT) == 2);
+    CHECK(frame > bytes);
+    if (frame > bytes) {
+        CHECK(memcmp(data, expected.data(), bytes) == 0);
+        bool reset = true;
+        for (size_t i = bytes; i < frame; i++) {
+            reset = reset && data[i] == 0;
+        }
+        CHECK(reset);
+    }
+}
+#endif
+
+int main()
+{
+    Host::setRealtime(false);
+
+    const uint16_t led_counts[] = {1, 2, 7, 100, 500};
+    for (uint8_t lane_count = 8; lane_count <= 16; lane_count += 8) {
+        for (size_t i = 0; i < sizeof(led_counts) / sizeof(led_counts[0]); i++) {
+            checkKernel(lane_count, led_counts[i], (unsigned)(lane_count + i));
+        }
+#if NEOLED_PARALLEL
+        checkStrip(lane_count);
+#endif
+    }
+
+    return testResult();
+}
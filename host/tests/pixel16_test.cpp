@@ -0,0 +1,170 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Pixel16 test: 16-bit frames encode like the 8-bit frames they round to,
+// and with dithering the LEDs average out to the 16-bit level on the
+// gamma curve
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+static const int LEDS = 300;
+
+static Pixel16 makePixel16(uint16_t r, uint16_t g, uint16_t b)
+{
+    Pixel16 pixel;
+    pixel.red = r;
+    pixel.green = g;
+    pixel.blue = b;
+    return pixel;
+}
+
+int main()
+{
+    Host::setRealtime(false);
+#if NEOLED_DITHER
+    std::vector<uint8_t> curve = gammaCurve(2.2f);
+#endif
+
+    std::vector<Pixel> pixels(LEDS);
+    std::vector<Pixel16> pixels16(LEDS);
+    for (int i = 0; i < LEDS; i++) {
+        pixels[i] = makePixel((uint8_t)(255 - i % 256), (uint8_t)i, (uint8_t)(i * 37));
+        pixels16[i] = makePixel16(pixels[i].red * 257, pixels[i].green * 257, pixels[i].blue * 257);
+    }
+
+    Strip strip(LEDS);
+    strip.setBackend(Host::captureBackend());
+    CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+    strip.setGamma(2.2f);
+    strip.setBrightness(100);
+
+    // v * 257 is the 16-bit form of v, so the frames match byte for byte
+    Host::resetCapture(0);
+    CHECK(strip.update(pixels.data()) == NEOLED_OK);
+    std::vector<uint8_t> frame = captured(0);
+    CHECK(strip.clear() == NEOLED_OK);
+    Host::resetCapture(0);
+    CHECK(strip.update(pixels16.data()) == NEOLED_OK);
+    CHECK(captured(0) == frame);
+#if NEOLED_DIRTY_TRACKING
+    CHECK(strip.update(pixels16.data()) == NEOLED_OK);
+    CHECK(strip.getSkippedPixels() == LEDS);
+#endif
+
+    // Values within half a step of v * 257 round to v
+    for (int i = 0; i < LEDS; i++) {
+        pixels16[i].green = (uint16_t)(pixels[i].green * 257 + (pixels[i].green < 255 ? 100 : 0));
+        pixels16[i].red = (uint16_t)(pixels[i].red * 257 - (pixels[i].red > 0 ? 100 : 0));
+    }
+    CHECK(strip.clear() == NEOLED_OK);
+    Host::resetCapture(0);
+    CHECK(strip.update(pixels16.data()) == NEOLED_OK);
+    CHECK(captured(0) == frame);
+#if NEOLED_ASYNC
+    CHECK(strip.clear() == NEOLED_OK);
+    Host::resetCapture(0);
+    CHECK(strip.updateAsync(pixels16.data()) == NEOLED_OK);
+    CHECK(strip.waitForUpdate(UINT32_MAX) == NEOLED_OK);
+    CHECK(captured(0) == frame);
+#endif
+
+#if NEOLED_DITHER
+    // Dithered, the average over refreshes follows the 16-bit level
+    for (int i = 0; i < LEDS; i++) {
+        pixels16[i] = makePixel16((uint16_t)(65535 - i * 97), (uint16_t)(i * 211), (uint16_t)(i * 13));
+    }
+    CHECK(strip.setDithering(true) == NEOLED_OK);
+    strip.setBrightness(10);
+    const int frames = 64;
+    std::vector<double> sum(LEDS * 3, 0.0);
+    for (int f = 0; f < frames; f++) {
+        Host::resetCapture(0);
+        CHECK((f == 0 ? strip.update(pixels16.data()) : strip.refresh()) == NEOLED_OK);
+        std::vector<std::vector<uint8_t> > sent = capturedFrames(0);
+        CHECK(sent.size() == 1 && sent[0].size() == LEDS * 3);
+        for (size_t i = 0; sent.size() == 1 && i < sent[0].size(); i++) {
+            sum[i] += sent[0][i];
+        }
+    }
+    double max_error = 0.0;
+    for (int i = 0; i < LEDS; i++) {
+        uint16_t channels[3] = {pixels16[i].green, pixels16[i].red, pixels16[i].blue};
+        for (int c = 0; c < 3; c++) {
+            // Between the two 8-bit values around it on the gamma curve
+            uint16_t fine = (uint16_t)(channels[c] - (channels[c] >> 8));
+            int low = fine >> 8;
+            int high = low < 255 ? low + 1 : 255;
+            double level = curve[low] + (curve[high] - curve[low]) * (fine & 0xFF) / 256.0;
+            double expected = level * 10.0 / 255.0;
+            max_error = std::max(max_error, fabs(sum[i * 3 + c] / frames - expected));
+        }
+    }
+    CHECK(max_error < 0.06);
+    CHECK(strip.setDithering(false) == NEOLED_OK);
+#endif
+    strip.destroy();
+
+    // Every 16-bit value encodes as round(v / 257), give or take one
+    {
+        Strip single(1);
+        single.setBackend(Host::captureBackend());
+        CHECK(single.initWithPin(19, 1) == NEOLED_OK);
+        for (int v = 0; v < 65536; v++) {
+            Pixel16 pixel = makePixel16(0, (uint16_t)v, 0);
+            Host::resetCapture(1);
+            CHECK(single.update(&pixel) == NEOLED_OK);
+            std::vector<std::vector<uint8_t> > sent = capturedFrames(1);
+            CHECK(sent.size() == 1 && sent[0].size() == 3);
+            if (sent.size() == 1 && sent[0].size() == 3) {
+                CHECK(abs(sent[0][0] - (int)floor(v / 257.0 + 0.5)) <= 1);
+            }
+        }
+        single.destroy();
+    }
+
+    // RGBW strips take Pixel16 with white off
+    {
+        Strip rgbw(4);
+        rgbw.setBackend(Host::captureBackend());
+        rgbw.setProtocol(NEOLED_SK6812_RGBW);
+        CHECK(rgbw.initWithPin(19, 1) == NEOLED_OK);
+        Pixel16 quad[4] = {makePixel16(0, 65535, 0), makePixel16(65535, 0, 0), makePixel16(0, 0, 65535),
+                           makePixel16(514, 257, 771)};
+        Host::resetCapture(1);
+        CHECK(rgbw.update(quad) == NEOLED_OK);
+        std::vector<std::vector<uint8_t> > sent = capturedFrames(1);
+        CHECK(sent.size() == 1 && sent[0].size() == 16);
+        if (sent.size() == 1 && sent[0].size() == 16) {
+            const uint8_t expected[16] = {255, 0, 0, 0, 0, 255, 0, 0, 0, 0, 255, 0, 1, 2, 3, 0};
+            CHECK(memcmp(sent[0].data(), expected, 16) == 0);
+        }
+        rgbw.destroy();
+    }
+
+    return testResult();
+}
@@ -0,0 +1,152 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Ports test: strips on I2S0 and I2S1 updated from two threads at once must
+// each send exactly their own frames, and two strips racing for one port
+// must leave exactly one of them owning it
+
+#include <atomic>
+#include <thread>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+static const int LEDS = 64;
+static const int FRAMES = 20;
+
+/**
+ * @brief Colour of one LED in one frame, different for every port and frame
+ */
+static Pixel framePixel(int port, int frame, int led)
+{
+    return makePixel((uint8_t)(frame + 1), (uint8_t)(led * 3 + port), (uint8_t)(port * 100 + frame));
+}
+
+/**
+ * @brief Send FRAMES frames to a strip on a port, from the calling thread
+ */
+static void drivePort(int port, neoled_err_t* result)
+{
+    Strip strip(LEDS);
+    neoled_err_t ret = strip.initWithPin(18 + port, port);
+    std::vector<Pixel> pixels(LEDS);
+    for (int frame = 0; frame < FRAMES && ret == NEOLED_OK; frame++) {
+        for (int i = 0; i < LEDS; i++) {
+            pixels[i] = framePixel(port, frame, i);
+        }
+        ret = strip.update(pixels.data());
+    }
+    strip.destroy();
+    *result = ret;
+}
+
+/**
+ * @brief Both ports driven concurrently; each capture holds the port's
+ *        clear frame, its own frames in order, and the closing clear frame
+ */
+static void checkConcurrentPorts(void)
+{
+    Host::resetCapture(0);
+    Host::resetCapture(1);
+    neoled_err_t results[2] = {NEOLED_ERR_TIMEOUT, NEOLED_ERR_TIMEOUT};
+    std::thread first(drivePort, 0, &results[0]);
+    std::thread second(drivePort, 1, &results[1]);
+    first.join();
+    second.join();
+
+    for (int port = 0; port < 2; port++) {
+        CHECK(results[port] == NEOLED_OK);
+        std::vector<std::vector<uint8_t> > frames = capturedFrames(port);
+        CHECK(frames.size() == FRAMES + 2);
+        if (frames.size() != FRAMES + 2) {
+            continue;
+        }
+        std::vector<uint8_t> off(LEDS * 3, 0);
+        CHECK(frames.front() == off);
+        CHECK(frames.back() == off);
+        for (int frame = 0; frame < FRAMES; frame++) {
+            std::vector<uint8_t> expected;
+            for (int i = 0; i < LEDS; i++) {
+                Pixel pixel = framePixel(port, frame, i);
+                expected.push_back(pixel.green);
+                expected.push_back(pixel.red);
+                expected.push_back(pixel.blue);
+            }
+            if (frames[frame + 1] != expected) {
+                printf("I2S%d frame %d does not match\n", port, frame);
+                CHECK(false);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Two strips initialised on the same port at the same moment
+ */
+static void checkClaimRace(void)
+{
+    for (int round = 0; round < 200; round++) {
+        Strip first(LEDS);
+        Strip second(LEDS);
+        Strip* strips[2] = {&first, &second};
+        neoled_err_t results[2] = {NEOLED_ERR_TIMEOUT, NEOLED_ERR_TIMEOUT};
+        std::atomic<bool> start(false);
+        std::thread racers[2];
+        for (int r = 0; r < 2; r++) {
+            racers[r] = std::thread([&strips, &results, &start, r]() {
+                while (!start.load()) {
+                }
+                results[r] = strips[r]->initWithPin(18 + r, 1);
+            });
+        }
+        start.store(true);
+        racers[0].join();
+        racers[1].join();
+
+        int winners = (results[0] == NEOLED_OK) + (results[1] == NEOLED_OK);
+        CHECK(winners == 1);
+        CHECK(results[0] == NEOLED_ERR_INIT || results[1] == NEOLED_ERR_INIT);
+        if (winners != 1) {
+            printf("Round %d: results %d and %d\n", round, results[0], results[1]);
+            break;
+        }
+
+        // The loser's failed init must not have released the winner's claim
+        Strip late(LEDS);
+        CHECK(late.initWithPin(20, 1) == NEOLED_ERR_INIT);
+        strips[results[0] == NEOLED_OK ? 0 : 1]->destroy();
+        CHECK(late.initWithPin(20, 1) == NEOLED_OK);
+        late.destroy();
+    }
+    Host::resetCapture(1);
+}
+
+int main()
+{
+    checkConcurrentPorts();
+
+    Host::setRealtime(false);
+    checkClaimRace();
+
+    return testResult();
+}
@@ -0,0 +1,166 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Power limit test: every frame goes out at the highest brightness its own
+// current allows, whether the previous frame was brighter or darker
+
+#include <cstdlib>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+static const int LEDS = 300;
+static const uint32_t CHANNEL_MA = 20;
+static const uint32_t LIMIT_MA = 5000;
+
+/**
+ * @brief Send a frame and decode what reached the wire
+ */
+static std::vector<uint8_t> send(Strip& strip, const std::vector<Pixel>& pixels, bool async)
+{
+    Host::resetCapture(0);
+    if (async) {
+        CHECK(strip.updateAsync(pixels.data()) == NEOLED_OK);
+        CHECK(strip.waitForUpdate(UINT32_MAX) == NEOLED_OK);
+    } else {
+        CHECK(strip.update(pixels.data()) == NEOLED_OK);
+    }
+    std::vector<std::vector<uint8_t> > frames = capturedFrames(0);
+    CHECK(frames.size() == 1);
+    return frames.empty() ? std::vector<uint8_t>() : frames.back();
+}
+
+static double wireCurrent(const std::vector<uint8_t>& channels)
+{
+    double sum = 0;
+    for (size_t i = 0; i < channels.size(); i++) {
+        sum += channels[i];
+    }
+    return sum * CHANNEL_MA / 255.0;
+}
+
+int main()
+{
+    Host::setRealtime(false);
+
+    Strip strip(LEDS);
+    strip.setBackend(Host::captureBackend());
+    CHECK(strip.initWithPin(21, 0) == NEOLED_OK);
+    strip.setPowerLimit(CHANNEL_MA, LIMIT_MA);
+
+    std::vector<Pixel> white(LEDS, makePixel(255, 255, 255));
+    std::vector<Pixel> one_red(LEDS, makePixel(0, 0, 0));
+    one_red[0] = makePixel(255, 0, 0);
+
+    // 300 white LEDs draw 18 A: brightness 70 fits 5 A
+    std::vector<uint8_t> wire = send(strip, white, false);
+    CHECK(wire.size() == LEDS * 3 && wire[0] == 70);
+    CHECK(strip.getEstimatedCurrent() <= LIMIT_MA);
+
+    // The next frame draws 20 mA and goes out at full brightness at once
+    wire = send(strip, one_red, false);
+    CHECK(wire.size() == LEDS * 3 && wire[1] == 255 && wire[0] == 0);
+    CHECK(strip.getEstimatedCurrent() == CHANNEL_MA);
+
+#if NEOLED_DIRTY_TRACKING
+    // The limit is chosen before encoding, so a change that keeps it encodes
+    // only the changed pixel, and one that moves it every pixel, once
+    wire = send(strip, white, false);
+    std::vector<Pixel> dimmer = white;
+    dimmer[5] = makePixel(254, 255, 255);
+    wire = send(strip, dimmer, false);
+    CHECK(wire.size() == LEDS * 3 && wire[0] == 70 && strip.getSkippedPixels() == LEDS - 1);
+    dimmer.assign(LEDS / 2, makePixel(255, 255, 255));
+    dimmer.resize(LEDS, makePixel(0, 0, 0));
+    wire = send(strip, dimmer, false);
+    CHECK(wire.size() == LEDS * 3 && wire[0] == 141 && strip.getSkippedPixels() == 0);
+#endif
+
+    wire = send(strip, white, true);
+    CHECK(wire.size() == LEDS * 3 && wire[0] == 70);
+    wire = send(strip, one_red, true);
+    CHECK(wire.size() == LEDS * 3 && wire[1] == 255);
+
+    // Random frames: a frame within budget is sent unscaled, one over budget
+    // at the highest brightness that fits
+    srand(1);
+    std::vector<Pixel> pixels(LEDS, makePixel(0, 0, 0));
+    for (int frame = 0; frame < 200; frame++) {
+        int changes = (frame % 10 == 0) ? LEDS : rand() % 40;
+        for (int c = 0; c < changes; c++) {
+            int i = rand() % LEDS;
+            pixels[i] = (rand() & 1) ? makePixel(0, 0, 0) : makePixel((uint8_t)rand(), (uint8_t)rand(), (uint8_t)rand());
+        }
+        if (frame % 7 == 0) {
+            pixels = (frame % 14 == 0) ? white : one_red;
+        }
+
+        double requested = 0;
+        std::vector<uint8_t> expected(LEDS * 3);
+        for (int i = 0; i < LEDS; i++) {
+            expected[i * 3] = pixels[i].green;
+            expected[i * 3 + 1] = pixels[i].red;
+            expected[i * 3 + 2] = pixels[i].blue;
+            requested += (pixels[i].red + pixels[i].green + pixels[i].blue) * (double)CHANNEL_MA / 255.0;
+        }
+
+        wire = send(strip, pixels, frame % 3 == 0);
+        double current = wireCurrent(wire);
+        if (requested <= LIMIT_MA) {
+            CHECK(wire == expected);
+        } else {
+            CHECK(current <= LIMIT_MA);
+            CHECK(current > LIMIT_MA * 0.97);
+        }
+    }
+
+    strip.destroy();
+
+#if NEOLED_DITHER
+    // A dithered frame at its own limit is one step of the sequence at that
+    // brightness: 300 LEDs at 200 draw 14 A, brightness 90 fits 5 A
+    {
+        std::vector<Pixel> grey(LEDS, makePixel(200, 200, 200));
+        std::vector<uint8_t> frames[2];
+        for (int limited = 0; limited < 2; limited++) {
+            Strip dithered(LEDS);
+            dithered.setBackend(Host::captureBackend());
+            CHECK(dithered.setDithering(true) == NEOLED_OK);
+            if (limited) {
+                dithered.setPowerLimit(CHANNEL_MA, LIMIT_MA);
+            } else {
+                dithered.setBrightness(90);
+            }
+            CHECK(dithered.initWithPin(21, 0) == NEOLED_OK);
+            Host::resetCapture(0);
+            CHECK(dithered.update(grey.data()) == NEOLED_OK);
+            CHECK(dithered.refresh() == NEOLED_OK);
+            frames[limited] = captured(0);
+            dithered.destroy();
+        }
+        CHECK(!frames[0].empty() && frames[0] == frames[1]);
+    }
+#endif
+
+    return testResult();
+}
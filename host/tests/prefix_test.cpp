@@ -0,0 +1,100 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Prefix test: updateRange() and auto-prefix frames must send only the LEDs
+// up to the last one asked for or changed, followed by the reset, and must
+// leave the rest of the encoded frame intact for the next full frame
+
+#include <cstring>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+/**
+ * @brief Check the captured write: the first count pixels, then the reset,
+ *        in a single write
+ */
+static bool sentPrefix(const std::vector<Pixel>& pixels, uint16_t count)
+{
+    std::vector<uint8_t> expected((size_t)count * PIXEL_SIZE + ZERO_BUFFER, 0);
+    for (uint16_t i = 0; i < count; i++) {
+        referenceEncode(pixels[i].green, &expected[i * PIXEL_SIZE]);
+        referenceEncode(pixels[i].red, &expected[i * PIXEL_SIZE + 4]);
+        referenceEncode(pixels[i].blue, &expected[i * PIXEL_SIZE + 8]);
+    }
+    std::vector<uint8_t> stream = captured(0);
+    if (stream != expected || Host::writeCount(0) != 1) {
+        printf("%u LEDs: sent %u bytes in %u writes, expected %u in one\n", count, (unsigned)stream.size(),
+               (unsigned)Host::writeCount(0), (unsigned)expected.size());
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    srand(4);
+    Host::setRealtime(false);
+    CHECK(init() == NEOLED_OK);
+
+    std::vector<Pixel> pixels(LED_NUMBER);
+    for (int i = 0; i < LED_NUMBER; i++) {
+        randomPixel(pixels[i]);
+    }
+    CHECK(update(pixels.data()) == NEOLED_OK);
+
+    // updateRange() sends exactly the LEDs it is given
+    const uint16_t counts[] = {1, 30, LED_NUMBER - 1, LED_NUMBER};
+    for (int c = 0; c < 4; c++) {
+        for (uint16_t i = 0; i < counts[c]; i++) {
+            randomPixel(pixels[i]);
+        }
+        Host::resetCapture(0);
+        CHECK(updateRange(pixels.data(), counts[c]) == NEOLED_OK);
+        CHECK(sentPrefix(pixels, counts[c]));
+    }
+
+    // Auto-prefix stops after the last changed LED, and sends nothing when
+    // nothing changed
+    setAutoPrefix(true);
+    const uint16_t changed[] = {41, 0, 7, LED_NUMBER - 1};
+    for (int c = 0; c < 4; c++) {
+        randomPixel(pixels[changed[c]]);
+        Host::resetCapture(0);
+        CHECK(update(pixels.data()) == NEOLED_OK);
+        CHECK(sentPrefix(pixels, NEOLED_DIRTY_TRACKING ? changed[c] + 1 : LED_NUMBER));
+    }
+    Host::resetCapture(0);
+    CHECK(update(pixels.data()) == NEOLED_OK);
+    CHECK(captured(0).size() == (NEOLED_DIRTY_TRACKING ? 0 : LED_NUMBER * PIXEL_SIZE + ZERO_BUFFER));
+
+    // The LEDs past each prefix, which the reset was written over, are sent
+    // as they were encoded
+    setAutoPrefix(false);
+    Host::resetCapture(0);
+    CHECK(update(pixels.data()) == NEOLED_OK);
+    CHECK(sentPrefix(pixels, LED_NUMBER));
+
+    destroy();
+    return testResult();
+}
@@ -0,0 +1,183 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Render task test: a producer std::thread submits numbered frames while the
+// render task sends them; frames must arrive whole, in order, with the last
+// one sent, and the settings the task reads must stay fixed while it runs
+
+#include <atomic>
+#include <thread>
+#include "freertos/task.h"
+#include "host_test.h"
+
+using namespace NeoLED;
+
+static const uint8_t MARK = 0x5a;  // Blue channel of every LED of a frame
+
+/**
+ * @brief Frame numbers of the captured writes, -1 for a torn frame
+ */
+static std::vector<int> sentFrames(int led_count)
+{
+    std::vector<std::vector<uint8_t> > frames = capturedFrames(0);
+    std::vector<int> ids;
+    for (size_t f = 0; f < frames.size(); f++) {
+        const std::vector<uint8_t>& frame = frames[f];
+        bool torn = frame.size() != (size_t)led_count * 3;
+        int id = frame.size() >= 3 ? frame[0] | frame[1] << 8 : -1;
+        for (size_t i = 0; i + 2 < frame.size(); i += 3) {
+            torn = torn || (frame[i] | frame[i + 1] << 8) != id || frame[i + 2] != MARK;
+        }
+        ids.push_back(torn ? -1 : id);
+    }
+    return ids;
+}
+
+static void checkProducer(bool realtime)
+{
+    const int led_count = 60;
+    const int count = 3000;
+    Host::setRealtime(realtime);
+
+    Strip strip(led_count);
+    strip.setBackend(Host::captureBackend());
+    CHECK(strip.initWithPin(21, 0) == NEOLED_OK);
+    CHECK(strip.submitFrame() == NEOLED_ERR_NOT_INIT);
+    CHECK(strip.acquireFrame() == NULL);
+    Host::resetCapture(0);
+
+    CHECK(strip.startRender(tskNO_AFFINITY) == NEOLED_OK);
+    CHECK(strip.startRender(0) == NEOLED_ERR_INIT);
+    std::vector<Pixel> pixels(led_count);
+    CHECK(strip.update(pixels.data()) == NEOLED_ERR_PARAM);
+    CHECK(strip.clear() == NEOLED_ERR_PARAM);
+    CHECK(strip.acquireFrameW() == NULL);
+
+    std::atomic<int> producer_errors(0);
+    std::thread producer([&]() {
+        for (int f = 1; f <= count; f++) {
+            Pixel* frame = strip.acquireFrame();
+            if (frame == NULL) {
+                producer_errors++;
+                return;
+            }
+            for (int i = 0; i < led_count; i++) {
+                frame[i].green = (uint8_t)f;
+                frame[i].red = (uint8_t)(f >> 8);
+                frame[i].blue = MARK;
+            }
+            if (strip.submitFrame() != NEOLED_OK) {
+                producer_errors++;
+            }
+            if (f % 64 == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    });
+
+    // Settings changes from the control task are refused while frames go
+    // out, so every frame keeps its numbers
+    neoled_color_correction_t warm = {255, 200, 150, 255, 0.0f, 0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 100; i++) {
+        strip.setBrightness(10);
+        strip.setGamma(2.2f);
+        strip.setPowerLimit(20, 100);
+        CHECK(strip.setColorCorrection(&warm) == NEOLED_ERR_PARAM);
+#if NEOLED_DITHER
+        CHECK(strip.setDithering(true) == NEOLED_ERR_PARAM);
+#endif
+    }
+    CHECK(strip.getBrightness() == 255);
+    CHECK(strip.getGamma() == 1.0f);
+    CHECK(strip.getPowerLimit() == 0);
+
+    producer.join();
+    CHECK(producer_errors == 0);
+    CHECK(strip.stopRender() == NEOLED_OK);
+
+    std::vector<int> ids = sentFrames(led_count);
+    uint32_t dropped = strip.getDroppedFrames();
+    int torn = 0;
+    int out_of_order = 0;
+    for (size_t i = 0; i < ids.size(); i++) {
+        torn += ids[i] < 0;
+        out_of_order += i > 0 && ids[i] <= ids[i - 1];
+    }
+    CHECK(torn == 0);
+    CHECK(out_of_order == 0);
+    CHECK(!ids.empty() && ids.back() == count);
+    CHECK(ids.size() + dropped == (size_t)count);
+    printf("realtime %d: %d submitted, %u sent, %u dropped\n", realtime, count, (unsigned)ids.size(),
+           (unsigned)dropped);
+
+    // Stopped: the strip is the application's again
+    CHECK(strip.setColorCorrection(&warm) == NEOLED_OK);
+    strip.setBrightness(10);
+    CHECK(strip.getBrightness() == 10);
+    CHECK(strip.clear() == NEOLED_OK);
+
+    // destroy() stops a running task
+    CHECK(strip.startRender(1) == NEOLED_OK);
+    Pixel* frame = strip.acquireFrame();
+    CHECK(frame != NULL);
+    if (frame != NULL) {
+        for (int i = 0; i < led_count; i++) {
+            frame[i] = makePixel(1, 2, MARK);
+        }
+        CHECK(strip.submitFrame() == NEOLED_OK);
+    }
+    CHECK(strip.destroy() == NEOLED_OK);
+    CHECK(strip.acquireFrame() == NULL);
+}
+
+static void checkRgbw(void)
+{
+    Host::setRealtime(false);
+    Strip strip(10);
+    strip.setBackend(Host::captureBackend());
+    CHECK(strip.setProtocol(NEOLED_SK6812_RGBW) == NEOLED_OK);
+    CHECK(strip.initWithPin(21, 0) == NEOLED_OK);
+    CHECK(strip.startRender(0) == NEOLED_OK);
+    CHECK(strip.acquireFrame() == NULL);
+    PixelW* frame = strip.acquireFrameW();
+    CHECK(frame != NULL);
+    if (frame != NULL) {
+        for (int i = 0; i < 10; i++) {
+            frame[i].red = 1;
+            frame[i].green = 2;
+            frame[i].blue = 3;
+            frame[i].white = 4;
+        }
+        CHECK(strip.submitFrame() == NEOLED_OK);
+    }
+    CHECK(strip.stopRender() == NEOLED_OK);
+    strip.destroy();
+}
+
+int main()
+{
+    checkProducer(false);
+    checkProducer(true);
+    checkRgbw();
+    return testResult();
+}
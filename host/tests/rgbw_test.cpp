@@ -0,0 +1,209 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// RGBW test: PixelW frames carry the RGB words of the same Pixel frame plus
+// a white word on every backend, and rgbToRgbw() moves the largest amount
+// of the white LED's colour into the white channel with no colour error
+
+#include <cstdlib>
+#include <cstring>
+#include "driver/rmt_tx.h"
+#include "host_test.h"
+
+using namespace NeoLED;
+
+static const int LEDS = 5;
+
+static PixelW makePixelWhite(uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+{
+    PixelW pixel;
+    pixel.red = r;
+    pixel.green = g;
+    pixel.blue = b;
+    pixel.white = w;
+    return pixel;
+}
+
+static void checkEncoding(void)
+{
+    PixelW rgbw[LEDS] = {makePixelWhite(0x34, 0x12, 0x56, 0x78), makePixelWhite(0, 0xff, 0, 0),
+                         makePixelWhite(0, 0, 0, 0xff), makePixelWhite(2, 1, 3, 4), makePixelWhite(0, 0, 0, 0)};
+    Pixel rgb[LEDS];
+    for (int i = 0; i < LEDS; i++) {
+        rgb[i] = makePixel(rgbw[i].red, rgbw[i].green, rgbw[i].blue);
+    }
+
+    std::vector<uint8_t> rgb_frame;
+    {
+        Strip strip(LEDS);
+        strip.setBackend(Host::captureBackend());
+        strip.setProtocol(NEOLED_SK6812);
+        CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+        CHECK(strip.update(rgbw) == NEOLED_ERR_PARAM);
+        Host::resetCapture(0);
+        CHECK(strip.update(rgb) == NEOLED_OK);
+        rgb_frame = captured(0);
+        strip.destroy();
+    }
+
+    Strip strip(LEDS);
+    strip.setBackend(Host::captureBackend());
+    CHECK(strip.setProtocol(NEOLED_SK6812_RGBW) == NEOLED_OK);
+    CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+    Host::resetCapture(0);
+    CHECK(strip.update(rgbw) == NEOLED_OK);
+    std::vector<uint8_t> frame = captured(0);
+    CHECK(frame.size() == LEDS * 16 + 32);
+    for (int i = 0; i < LEDS && frame.size() == LEDS * 16 + 32; i++) {
+        CHECK(memcmp(&frame[i * 16], &rgb_frame[i * 12], 12) == 0);
+        CHECK(decodeByte(&frame[i * 16 + 12]) == rgbw[i].white);
+    }
+
+    // The same frame again is skipped whole; a Pixel frame turns white off,
+    // so only the LEDs that had no white stay unchanged
+    Host::resetCapture(0);
+    CHECK(strip.update(rgbw) == NEOLED_OK);
+#if NEOLED_DIRTY_TRACKING
+    CHECK(strip.getSkippedPixels() == LEDS);
+#endif
+    Host::resetCapture(0);
+    CHECK(strip.update(rgb) == NEOLED_OK);
+#if NEOLED_DIRTY_TRACKING
+    CHECK(strip.getSkippedPixels() == 2);
+#endif
+    std::vector<uint8_t> white_off = captured(0);
+    for (int i = 0; i < LEDS && white_off.size() >= (size_t)LEDS * 16; i++) {
+        CHECK(memcmp(&white_off[i * 16], &rgb_frame[i * 12], 12) == 0);
+        CHECK(decodeByte(&white_off[i * 16 + 12]) == 0);
+    }
+
+#if NEOLED_ASYNC
+    Host::resetCapture(0);
+    CHECK(strip.updateAsync(rgbw) == NEOLED_OK);
+    CHECK(strip.waitForUpdate(UINT32_MAX) == NEOLED_OK);
+    std::vector<uint8_t> async_frame = captured(0);
+    CHECK(async_frame == frame);
+#endif
+    strip.destroy();
+
+    // RMT: one symbol per bit, white after blue
+    {
+        Strip rmt(LEDS);
+        rmt.setBackend(rmtBackend());
+        rmt.setProtocol(NEOLED_SK6812_RGBW);
+        CHECK(rmt.initWithPin(18, 0) == NEOLED_OK);
+        Host::resetCapture(Host::RMT_PORT);
+        CHECK(rmt.update(rgbw) == NEOLED_OK);
+        size_t size = 0;
+        const rmt_symbol_word_t* symbols = (const rmt_symbol_word_t*)Host::captureData(Host::RMT_PORT, &size);
+        CHECK(size / sizeof(rmt_symbol_word_t) == LEDS * 32 + 1);
+        uint8_t white = 0;
+        for (int b = 0; b < 8; b++) {
+            white = (uint8_t)(white << 1 | (symbols[24 + b].duration0 > 4));
+        }
+        CHECK(white == rgbw[0].white);
+        rmt.destroy();
+    }
+
+    // SPI: 12 bytes per LED
+    {
+        Strip spi(LEDS);
+        spi.setBackend(spiBackend());
+        spi.setProtocol(NEOLED_SK6812_RGBW);
+        CHECK(spi.initWithPin(18, 2) == NEOLED_OK);
+        Host::resetCapture(Host::SPI_PORT);
+        CHECK(spi.update(rgbw) == NEOLED_OK);
+        spi.destroy();
+        // The update is the frame before destroy()'s clear frame
+        std::vector<uint8_t> stream = captured(Host::SPI_PORT);
+        uint32_t writes = Host::writeCount(Host::SPI_PORT);
+        CHECK(writes >= 2 && stream.size() % writes == 0);
+        size_t frame_bytes = writes != 0 ? stream.size() / writes : 0;
+        CHECK(frame_bytes > LEDS * 12);
+        if (writes >= 2 && frame_bytes > LEDS * 12) {
+            const uint8_t* frame = &stream[(writes - 2) * frame_bytes];
+            uint8_t white = 0;
+            for (int b = 0; b < 8; b++) {
+                size_t bit = (24 + b) * 3 + 1;  // Middle bit of each 3-bit pattern
+                white = (uint8_t)(white << 1 | ((frame[bit / 8] >> (7 - bit % 8)) & 1));
+            }
+            CHECK(white == rgbw[0].white);
+        }
+    }
+}
+
+static void checkConversion(void)
+{
+    const int count = 1024;
+    std::vector<Pixel> in(count);
+    std::vector<PixelW> out(count);
+    srand(1);
+    for (int i = 0; i < count; i++) {
+        randomPixel(in[i]);
+    }
+    in[0] = makePixel(255, 255, 255);
+
+    rgbToRgbw(in.data(), out.data(), count, NEOLED_WHITE_NONE);
+    for (int i = 0; i < count; i++) {
+        CHECK(out[i].white == 0 && out[i].red == in[i].red && out[i].green == in[i].green &&
+              out[i].blue == in[i].blue);
+    }
+
+    rgbToRgbw(in.data(), out.data(), count, NEOLED_WHITE_MIN);
+    for (int i = 0; i < count; i++) {
+        int grey = std::min(in[i].red, std::min(in[i].green, in[i].blue));
+        CHECK(out[i].white == grey && out[i].red + grey == in[i].red && out[i].green + grey == in[i].green &&
+              out[i].blue + grey == in[i].blue);
+    }
+
+    const uint16_t kelvins[] = {2000, 2700, 4500, 6500, 10000};
+    for (size_t k = 0; k < sizeof(kelvins) / sizeof(kelvins[0]); k++) {
+        rgbToRgbw(in.data(), out.data(), count, NEOLED_WHITE_TEMPERATURE, kelvins[k]);
+
+        // Full white becomes the white LED plus what RGB must add to it, so
+        // that is the white LED's colour
+        CHECK(out[0].white == 255);
+        int point[3] = {255 - out[0].red, 255 - out[0].green, 255 - out[0].blue};
+        for (int i = 0; i < count; i++) {
+            int w = out[i].white;
+            int channel_in[3] = {in[i].red, in[i].green, in[i].blue};
+            int channel_out[3] = {out[i].red, out[i].green, out[i].blue};
+            // The fixed-point scales round down, so white may be one step
+            // short of the exact largest multiple, never more
+            bool more_fits = w < 254;
+            for (int c = 0; c < 3; c++) {
+                CHECK(channel_out[c] + (w * point[c] + 127) / 255 == channel_in[c]);
+                more_fits = more_fits && (w + 2) * point[c] <= channel_in[c] * 255;
+            }
+            CHECK(!more_fits);
+        }
+    }
+}
+
+int main()
+{
+    Host::setRealtime(false);
+    checkEncoding();
+    checkConversion();
+    return testResult();
+}
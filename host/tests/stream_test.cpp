@@ -0,0 +1,177 @@
+/** MIT licence
+
+ Copyright (C) 2019 by Vu Nam https://github.com/vunam https://studiokoda.com
+ Copyright (C) 2024-2026 Contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions: The above copyright notice and this
+ permission notice shall be included in all copies or substantial portions of
+ the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+ EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+
+*/
+// Streaming test: a strip encoding into a ring of chunks sends the same
+// stream as one encoding whole frames, for every chunk size, pixel type,
+// colour pipeline and backend that supports it
+
+#include <cstdlib>
+#include "host_test.h"
+
+using namespace NeoLED;
+
+struct Options {
+    neoled_protocol_t protocol;
+    neoled_color_order_t order;
+    uint8_t brightness;
+    float gamma;
+    bool correction;
+    uint32_t limit_ma;
+    const neoled_backend_t* backend;
+};
+
+/**
+ * @brief Everything a strip sends from init() to destroy() for some frames
+ * @param chunk LEDs per chunk, 0 for whole frames
+ */
+template <typename P>
+static std::vector<uint8_t> run(const Options& options, uint16_t chunk, const std::vector<std::vector<P> >& frames,
+                                uint32_t* writes, uint32_t* current_ma)
+{
+    std::vector<uint8_t> sent = captureStrip(
+        (uint16_t)frames[0].size(), options.backend,
+        [&](Strip& strip) {
+            strip.setProtocol(options.protocol);
+            strip.setColorOrder(options.order);
+            strip.setBrightness(options.brightness);
+            strip.setGamma(options.gamma);
+            if (options.limit_ma != 0) {
+                strip.setPowerLimit(20, options.limit_ma);
+            }
+            if (options.correction) {
+                neoled_color_correction_t correction = {255, 176, 240, 200, 0.0f, 2.6f, 0.0f, 0.0f};
+                CHECK(strip.setColorCorrection(&correction) == NEOLED_OK);
+            }
+            CHECK(strip.setStreaming(chunk) == NEOLED_OK);
+        },
+        [&](Strip& strip) {
+            for (size_t f = 0; f < frames.size(); f++) {
+                CHECK(strip.update(frames[f].data()) == NEOLED_OK);
+            }
+            *current_ma = strip.getEstimatedCurrent();
+        });
+    *writes = Host::writeCount(capturePort(options.backend));
+    return sent;
+}
+
+template <typename P>
+static void compare(const Options& options, int count)
+{
+    std::vector<std::vector<P> > frames(3, std::vector<P>(count));
+    for (size_t f = 0; f < frames.size(); f++) {
+        for (int i = 0; i < count; i++) {
+            randomPixel(frames[f][i]);
+        }
+    }
+    for (int i = 0; i < count; i += 3) {
+        frames[1][i] = frames[0][i];
+    }
+
+    uint32_t whole_writes = 0, whole_ma = 0;
+    std::vector<uint8_t> whole = run(options, 0, frames, &whole_writes, &whole_ma);
+    const uint16_t chunks[5] = {1, 7, 64, (uint16_t)count, (uint16_t)(count + 50)};
+    for (int c = 0; c < 5; c++) {
+        uint32_t writes = 0, current_ma = 0;
+        std::vector<uint8_t> streamed = run(options, chunks[c], frames, &writes, &current_ma);
+        uint16_t chunk = chunks[c] < count ? chunks[c] : (uint16_t)count;
+        // The clear frames of init() and destroy() and three updates, one
+        // write per chunk each
+        CHECK(!streamed.empty() && streamed == whole);
+        CHECK(writes == 5 * (uint32_t)((count + chunk - 1) / chunk));
+        CHECK(current_ma == whole_ma);
+    }
+}
+
+int main()
+{
+    Host::setRealtime(false);
+    srand(9);
+
+    const neoled_backend_t* capture = Host::captureBackend();
+    Options plain = {NEOLED_WS2812, NEOLED_ORDER_DEFAULT, 255, 1.0f, false, 0, capture};
+    Options corrected = {NEOLED_WS2812, NEOLED_ORDER_BRG, 180, 2.2f, true, 0, capture};
+    Options limited = {NEOLED_WS2811, NEOLED_ORDER_DEFAULT, 200, 2.0f, false, 3000, capture};
+    Options rgbw = {NEOLED_SK6812_RGBW, NEOLED_ORDER_DEFAULT, 220, 2.2f, true, 4000, capture};
+    Options spi = {NEOLED_WS2812, NEOLED_ORDER_DEFAULT, 255, 2.2f, false, 0, spiBackend()};
+    compare<Pixel>(plain, 300);
+    compare<Pixel>(corrected, 300);
+    compare<Pixel>(limited, 300);
+    compare<PixelW>(rgbw, 150);
+#if NEOLED_PIXEL16
+    Options wide = {NEOLED_WS2812, NEOLED_ORDER_GRB, 255, 2.2f, false, 0, capture};
+    compare<Pixel16>(wide, 200);
+#endif
+    compare<Pixel>(spi, 120);
+
+    // The streamed limit holds for each frame, bright or dark
+    {
+        const int count = 200;
+        std::vector<Pixel> bright(count, makePixel(255, 255, 255));
+        std::vector<Pixel> dark(count, makePixel(40, 0, 0));
+        Strip strip(count);
+        strip.setBackend(capture);
+        CHECK(strip.setStreaming(32) == NEOLED_OK);
+        strip.setPowerLimit(20, 3000);
+        CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+        CHECK(strip.update(bright.data()) == NEOLED_OK);
+        CHECK(strip.getEstimatedCurrent() <= 3000 && strip.getEstimatedCurrent() > 2900);
+        CHECK(strip.update(dark.data()) == NEOLED_OK);
+        CHECK(strip.getEstimatedCurrent() == 40 * 20 * count / 255);
+        strip.destroy();
+    }
+
+    // Streaming rules out whole-frame features, and needs a ring backend
+    {
+        Strip strip(100);
+        strip.setBackend(capture);
+        CHECK(strip.setStreaming(16) == NEOLED_OK);
+        CHECK(strip.getStreaming() == 16);
+#if NEOLED_DITHER
+        CHECK(strip.setDithering(true) == NEOLED_OK);
+        CHECK(strip.initWithPin(18, 0) == NEOLED_ERR_PARAM);
+        CHECK(strip.setDithering(false) == NEOLED_OK);
+#endif
+        CHECK(strip.initWithPin(18, 0) == NEOLED_OK);
+        CHECK(strip.setStreaming(0) == NEOLED_ERR_INIT);
+#if NEOLED_DITHER
+        CHECK(strip.setDithering(true) == NEOLED_ERR_PARAM);
+        CHECK(!strip.getDithering());
+#endif
+#if NEOLED_ASYNC
+        std::vector<Pixel> pixels(100);
+        CHECK(strip.updateAsync(pixels.data()) == NEOLED_ERR_PARAM);
+#endif
+        neoled_stream_stats_t stats;
+        strip.getStreamStats(&stats);
+        CHECK(stats.slack_us > 0 && stats.encode_us < stats.slack_us && stats.underruns == 0);
+        strip.destroy();
+        CHECK(strip.setStreaming(0) == NEOLED_OK);
+
+        Strip rmt(10);
+        rmt.setBackend(rmtBackend());
+        CHECK(rmt.setStreaming(4) == NEOLED_OK);
+        CHECK(rmt.initWithPin(18, 0) == NEOLED_ERR_PARAM);
+    }
+
+    return testResult();
+}
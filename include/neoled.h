@@ -24,6 +24,7 @@
 #ifndef NEOLED_H
 #define NEOLED_H
 
+#include <cstddef>
 #include <cstdint>
 
 // Library version
@@ -56,14 +57,20 @@ namespace NeoLED {
 #endif
 
 #ifndef SAMPLE_RATE
-    #define SAMPLE_RATE (93750)
+    #define SAMPLE_RATE (93750)  // WS2812 I2S sample rate: four 0.33 us slots per 1.33 us bit
+#endif
+
+#ifndef NEOLED_RESET_US
+    #define NEOLED_RESET_US 300  // WS2812 reset/latch low time (WS2812B needs >280 us, WS2812 >50 us)
 #endif
 
 #ifndef ZERO_BUFFER
-    #define ZERO_BUFFER 48
+    // WS2812 reset signal: NEOLED_RESET_US of zero samples (4 bytes each at SAMPLE_RATE), rounded up
+    #define ZERO_BUFFER ((int)((((unsigned long long)(NEOLED_RESET_US) * (SAMPLE_RATE) + 999999ULL) / 1000000ULL) * 4))
 #endif
 
 #ifndef I2S_NUM
+    // I2S peripheral used by init() and initWithPin(gpio_pin)
     #define I2S_NUM (0)
 #endif
 
@@ -71,6 +78,107 @@ namespace NeoLED {
     #define I2S_DO_IO (21)
 #endif
 
+#ifndef NEOLED_ENCODER_LUT
+    #define NEOLED_ENCODER_LUT 1  // 1 = 256-entry byte-to-word table, 0 = 2-bit bitpatterns lookups
+#endif
+
+#ifndef NEOLED_DIRTY_TRACKING
+    #define NEOLED_DIRTY_TRACKING 1  // Re-encode only pixels that changed since the last update
+#endif
+
+#ifndef NEOLED_ASYNC
+    #define NEOLED_ASYNC 1  // Double-buffered updateAsync() with a writer task
+#endif
+
+#ifndef NEOLED_RENDER
+    #define NEOLED_RENDER 1  // Optional render task fed by submitFrame(), see startRender()
+#endif
+
+#ifndef NEOLED_DMA_DESC_BYTES
+    #define NEOLED_DMA_DESC_BYTES 4092  // Max bytes per DMA descriptor (fewer, larger = fewer interrupts)
+#endif
+
+#if NEOLED_DMA_DESC_BYTES > 4092 || NEOLED_DMA_DESC_BYTES < 32
+    #error "NEOLED_DMA_DESC_BYTES must be between 32 and 4092"
+#endif
+
+#ifndef NEOLED_DMA_DESC_NUM_MAX
+    #define NEOLED_DMA_DESC_NUM_MAX 0  // Cap on DMA descriptors (0 = enough for a whole frame)
+#endif
+
+#ifndef NEOLED_STREAM_DEPTH
+    #define NEOLED_STREAM_DEPTH 3  // Chunks the I2S DMA ring holds in streaming mode, see setStreaming()
+#endif
+
+#if NEOLED_STREAM_DEPTH < 2
+    #error "NEOLED_STREAM_DEPTH must be at least 2"
+#endif
+
+#ifndef NEOLED_TASK_STACK_SIZE
+    #define NEOLED_TASK_STACK_SIZE 3072
+#endif
+
+#ifndef NEOLED_TASK_PRIORITY
+    #define NEOLED_TASK_PRIORITY 5
+#endif
+
+#ifndef NEOLED_RMT
+    #define NEOLED_RMT 1  // RMT output backend, rmtBackend()
+#endif
+
+#ifndef NEOLED_RMT_RESOLUTION_HZ
+    #define NEOLED_RMT_RESOLUTION_HZ (10000000)  // RMT tick rate (10 MHz = 0.1 us ticks)
+#endif
+
+#ifndef NEOLED_RMT_MEM_SYMBOLS
+    #define NEOLED_RMT_MEM_SYMBOLS 64  // RMT channel memory in symbols (one per bit), refilled each half
+#endif
+
+#ifndef NEOLED_SPI
+    #define NEOLED_SPI 1  // SPI master output backend, spiBackend()
+#endif
+
+#ifndef NEOLED_SPI_CLOCK_HZ
+    #define NEOLED_SPI_CLOCK_HZ (2400000)  // WS2812 SPI clock: 3 SPI bits per 1.25 us bit
+#endif
+
+#ifndef NEOLED_SPI_RESET_BYTES
+    // WS2812 reset signal: NEOLED_RESET_US of zero bits at NEOLED_SPI_CLOCK_HZ, rounded up
+    #define NEOLED_SPI_RESET_BYTES ((int)(((unsigned long long)(NEOLED_RESET_US) * (NEOLED_SPI_CLOCK_HZ) + 7999999ULL) / 8000000ULL))
+#endif
+
+#ifndef NEOLED_SPI_QUEUE_DEPTH
+    #define NEOLED_SPI_QUEUE_DEPTH 2  // SPI frames queued to the DMA at once (one DMA buffer each)
+#endif
+
+#ifndef NEOLED_COLOR_ORDERS
+    #define NEOLED_COLOR_ORDERS 1  // Encoders for all six colour orders (0 = GRB and RGB only, less flash)
+#endif
+
+#ifndef NEOLED_CHANNEL_MA
+    #define NEOLED_CHANNEL_MA 20  // Default current of one LED channel at full level, see setPowerLimit()
+#endif
+
+#ifndef NEOLED_PIXEL16
+    #define NEOLED_PIXEL16 1  // update() and updateAsync() take Pixel16 arrays (0 = less flash)
+#endif
+
+#ifndef NEOLED_DITHER
+    #define NEOLED_DITHER 1  // Temporal dithering, setDithering() and refresh()
+#endif
+
+#ifndef NEOLED_PARALLEL
+    #define NEOLED_PARALLEL 0  // ParallelStrip: 8 or 16 strips from one LCD/parallel-mode peripheral
+#endif
+
+#if NEOLED_PARALLEL && !NEOLED_USE_NEW_I2S_DRIVER
+    #error "NEOLED_PARALLEL requires ESP-IDF 5.x (esp_lcd i80 bus)"
+#endif
+
+#ifndef NEOLED_PARALLEL_CLOCK_HZ
+    #define NEOLED_PARALLEL_CLOCK_HZ (2400000)  // Parallel sample clock: 3 samples per 1.25 us WS2812 bit
+#endif
+
 // ============================================================================
 // Error Codes
 // ============================================================================
@@ -81,9 +189,150 @@ typedef enum {
     NEOLED_ERR_PARAM = -2,      // Invalid parameter
     NEOLED_ERR_NO_MEM = -3,     // Memory allocation failed
     NEOLED_ERR_NOT_INIT = -4,   // Not initialized
-    NEOLED_ERR_I2S = -5         // I2S operation failed
+    NEOLED_ERR_I2S = -5,        // I2S (or other backend) operation failed
+    NEOLED_ERR_TIMEOUT = -6     // Timed out waiting for the driver
 } neoled_err_t;
 
+/**
+ * @brief DMA memory reserved by the I2S driver
+ */
+typedef struct {
+    uint32_t desc_num;      // Number of DMA descriptors (one interrupt each)
+    uint32_t desc_bytes;    // Bytes per descriptor
+    size_t total_bytes;     // Total DMA memory (desc_num * desc_bytes)
+} neoled_dma_info_t;
+
+/**
+ * @brief Completion callback for updateAsync()
+ * @param result NEOLED_OK if the frame was sent, error code otherwise
+ * @param user_data Pointer passed to setUpdateCallback()
+ * @note Runs in the NeoLED writer task; keep it short and non-blocking
+ *       (e.g. xTaskNotifyGive() to the render task)
+ */
+typedef void (*neoled_update_cb_t)(neoled_err_t result, void* user_data);
+
+// ============================================================================
+// LED Protocols
+// ============================================================================
+
+/**
+ * @brief LED chip protocol: bit timing, reset time and colour order
+ * @note Timings are high times for a 0 and a 1 bit and the bit period. The
+ *       I2S backend approximates them with four slots per bit, the SPI
+ *       backend with three; RMT uses them as given.
+ */
+typedef enum {
+    NEOLED_WS2812 = 0,  // 0.4/0.8 us of 1.25 us, NEOLED_RESET_US reset, GRB (default)
+    NEOLED_SK6812 = 1,  // 0.3/0.6 us of 1.25 us, 80 us reset, GRB
+    NEOLED_WS2811 = 2,  // 0.5/1.2 us of 2.5 us (400 kHz), 300 us reset, RGB
+    NEOLED_WS2815 = 3,  // 0.3/0.75 us of 1.25 us, 280 us reset, GRB
+    NEOLED_APA106 = 4,  // 0.35/1.36 us of 1.71 us, 50 us reset, RGB
+    NEOLED_SK6812_RGBW = 5  // SK6812 timing, GRBW (takes PixelW, see update(const PixelW*))
+} neoled_protocol_t;
+
+/**
+ * @brief Order in which an LED takes its colour channels from the wire
+ * @note White, on RGBW protocols, always follows the three colours
+ */
+typedef enum {
+    NEOLED_ORDER_DEFAULT = 0,   // The protocol's own order
+    NEOLED_ORDER_RGB = 1,
+    NEOLED_ORDER_RBG = 2,
+    NEOLED_ORDER_GRB = 3,
+    NEOLED_ORDER_GBR = 4,
+    NEOLED_ORDER_BRG = 5,
+    NEOLED_ORDER_BGR = 6
+} neoled_color_order_t;
+
+/**
+ * @brief How rgbToRgbw() moves colour into the white channel
+ */
+typedef enum {
+    NEOLED_WHITE_NONE = 0,        // White off, RGB copied unchanged
+    NEOLED_WHITE_MIN = 1,         // min(R, G, B) moved to white
+    NEOLED_WHITE_TEMPERATURE = 2  // As much of the white LED's own colour as RGB contains
+} neoled_white_mode_t;
+
+// ============================================================================
+// Output Backends
+// ============================================================================
+
+/**
+ * @brief Frame layout a backend expects from write()
+ */
+typedef enum {
+    NEOLED_FRAME_I2S = 0,   // PIXEL_SIZE encoded bytes per LED (16 for RGBW), then the reset samples
+    NEOLED_FRAME_GRB = 1,   // Three colour bytes per LED (four for RGBW, brightness and gamma applied), no reset
+    NEOLED_FRAME_SPI = 2    // NEOLED_SPI_PIXEL_SIZE encoded bytes per LED (12 for RGBW), then the reset bytes
+} neoled_frame_format_t;
+
+/**
+ * @brief Settings handed to a backend's init()
+ */
+typedef struct {
+    int port;                // Peripheral instance (I2S port for the I2S backend)
+    int gpio_pin;            // Data output GPIO
+    uint32_t sample_rate;    // 16-bit stereo sample frames per second (4 bytes each)
+    uint32_t dma_desc_num;   // DMA descriptors sized for one encoded frame
+    uint32_t dma_frame_num;  // Sample frames per descriptor
+    size_t frame_bytes;      // Longest frame write() will be given
+    uint32_t t0h_ns;         // LED protocol: high time of a 0 bit
+    uint32_t t1h_ns;         // LED protocol: high time of a 1 bit
+    uint32_t bit_ns;         // LED protocol: bit period
+    uint32_t reset_us;       // LED protocol: low time that latches a frame
+    uint32_t spi_clock_hz;   // SPI clock for three SPI bits per LED bit
+} neoled_backend_config_t;
+
+/**
+ * @brief Output backend: moves encoded frames to the LEDs and ends each one
+ *        with the reset signal
+ * @note write() must copy or send the data before returning, as the buffer is
+ *       reused right after. Calls for one strip are never concurrent.
+ */
+typedef struct {
+    const char* name;
+    neoled_frame_format_t format;
+
+    /** @brief Claim the peripheral and store per-strip state in *handle */
+    neoled_err_t (*init)(const neoled_backend_config_t* config, void** handle);
+
+    /** @brief Queue one encoded frame, blocking while the backend is full */
+    neoled_err_t (*write)(void* handle, const uint8_t* data, size_t length);
+
+    /** @brief Wait until everything written has left the data pin */
+    neoled_err_t (*flush)(void* handle, uint32_t timeout_ms);
+
+    /** @brief Release the peripheral and the data GPIO */
+    void (*deinit)(void* handle);
+} neoled_backend_t;
+
+/**
+ * @brief Get the I2S backend for the ESP-IDF version in use (the default)
+ * @return i2s_std backend on ESP-IDF 5.x, i2s_legacy backend on 4.x
+ */
+const neoled_backend_t* i2sBackend(void);
+
+#if NEOLED_RMT
+/**
+ * @brief Get the RMT backend
+ * @return Backend sending colour frames through an RMT TX channel
+ * @note On ESP-IDF 5.x the port is ignored and a free channel is allocated;
+ *       on 4.x the port selects the RMT channel
+ */
+const neoled_backend_t* rmtBackend(void);
+#endif
+
+#if NEOLED_SPI
+/**
+ * @brief Get the SPI backend
+ * @return Backend sending SPI frames from an SPI master's MOSI pin through
+ *         NEOLED_SPI_QUEUE_DEPTH queued DMA transactions
+ * @note The port selects the SPI host (SPI2_HOST or SPI3_HOST), which the
+ *       strip takes over completely
+ */
+const neoled_backend_t* spiBackend(void);
+#endif
+
 // ============================================================================
 // Pixel Structure
 // ============================================================================
@@ -99,7 +348,8 @@ typedef struct {
 } Pixel;
 
 /**
- * @brief Extended pixel structure for RGBW LEDs (future use)
+ * @brief Pixel structure for RGBW LEDs
+ * @note SK6812 RGBW uses GRBW format, so the order is green, red, blue, white
  */
 typedef struct {
     uint8_t green;
@@ -108,6 +358,40 @@ typedef struct {
     uint8_t white;
 } PixelW;
 
+/**
+ * @brief Pixel structure with 16 bits per channel, see update(const Pixel16*)
+ * @note Same order as Pixel; 0xffff is full on
+ */
+typedef struct {
+    uint16_t green;
+    uint16_t red;
+    uint16_t blue;
+} Pixel16;
+
+/**
+ * @brief Per-channel colour correction, see setColorCorrection()
+ * @note Scales are applied after gamma, on top of the strip brightness
+ */
+typedef struct {
+    uint8_t red;          // White balance scale of each channel, 255 = unchanged
+    uint8_t green;
+    uint8_t blue;
+    uint8_t white;        // RGBW strips only
+    float gamma_red;      // Gamma of each channel, 0 = the strip's setGamma() value
+    float gamma_green;
+    float gamma_blue;
+    float gamma_white;
+} neoled_color_correction_t;
+
+/**
+ * @brief Streaming timings, see getStreamStats()
+ */
+typedef struct {
+    uint32_t encode_us;   // Longest chunk encode of the last frame
+    uint32_t slack_us;    // Longest chunk encode the DMA ring covers
+    uint32_t underruns;   // Chunks since init whose encode took longer than slack_us
+} neoled_stream_stats_t;
+
 // ============================================================================
 // Predefined Colors (in RGB order for user convenience)
 // These create Pixel structs with correct GRB internal ordering
@@ -148,7 +432,292 @@ typedef struct {
 #define HUE_OFF        0      // Turn off LED (set RGB values to zero)
 
 // ============================================================================
-// Core Functions
+// Strip Class
+// ============================================================================
+
+struct StripState;
+
+/**
+ * @brief LED strip with a runtime LED count
+ * @note The encoded frame buffers are allocated once from DMA-capable memory
+ *       on the first init() and freed when the Strip is destroyed. Each
+ *       initialized strip owns one peripheral instance of its backend.
+ */
+class Strip {
+public:
+    /**
+     * @brief Create a strip (no hardware or buffers are touched until init)
+     * @param led_count Number of LEDs in the strip
+     */
+    explicit Strip(uint16_t led_count);
+    ~Strip();
+
+    /** @brief Initialize on the default GPIO (I2S_DO_IO), see NeoLED::init() */
+    neoled_err_t init(void);
+
+    /** @brief Initialize on a custom GPIO pin, see NeoLED::initWithPin() */
+    neoled_err_t initWithPin(int gpio_pin);
+
+    /** @brief Initialize on a custom GPIO pin and peripheral, see NeoLED::initWithPin() */
+    neoled_err_t initWithPin(int gpio_pin, int port);
+
+    /** @brief Select the output backend before init, see NeoLED::setBackend() */
+    neoled_err_t setBackend(const neoled_backend_t* backend);
+    const neoled_backend_t* getBackend(void) const;
+
+    /** @brief Select the LED chip protocol before init, see NeoLED::setProtocol() */
+    neoled_err_t setProtocol(neoled_protocol_t protocol);
+    neoled_protocol_t getProtocol(void) const;
+
+    /** @brief Override the protocol's colour order before init, see NeoLED::setColorOrder() */
+    neoled_err_t setColorOrder(neoled_color_order_t order);
+    neoled_color_order_t getColorOrder(void) const;
+
+    /** @brief Update the strip with the strip brightness, see NeoLED::update() */
+    neoled_err_t update(const Pixel* pixels);
+
+    /** @brief Update with a per-call brightness, see NeoLED::updateWithBrightness() */
+    neoled_err_t updateWithBrightness(const Pixel* pixels, uint8_t brightness);
+
+    /** @brief Update an RGBW strip, see NeoLED::update(const PixelW*) */
+    neoled_err_t update(const PixelW* pixels);
+    neoled_err_t updateWithBrightness(const PixelW* pixels, uint8_t brightness);
+
+#if NEOLED_PIXEL16
+    /** @brief Update from 16-bit pixels, see NeoLED::update(const Pixel16*) */
+    neoled_err_t update(const Pixel16* pixels);
+    neoled_err_t updateWithBrightness(const Pixel16* pixels, uint8_t brightness);
+#endif
+
+    /** @brief Update and send only the first count LEDs, see NeoLED::updateRange() */
+    neoled_err_t updateRange(const Pixel* pixels, uint16_t count);
+
+#if NEOLED_ASYNC
+    /** @brief Queue a frame without waiting for the wire, see NeoLED::updateAsync() */
+    neoled_err_t updateAsync(const Pixel* pixels);
+    neoled_err_t updateAsync(const PixelW* pixels);
+#if NEOLED_PIXEL16
+    neoled_err_t updateAsync(const Pixel16* pixels);
+#endif
+
+    /** @brief Wait for queued frames, see NeoLED::waitForUpdate() */
+    neoled_err_t waitForUpdate(uint32_t timeout_ms);
+
+    /** @brief Set the asynchronous completion callback, see NeoLED::setUpdateCallback() */
+    void setUpdateCallback(neoled_update_cb_t callback, void* user_data);
+#endif
+
+    /** @brief Writable view of the library-owned framebuffer, see NeoLED::getPixels() */
+    Pixel* getPixels(void);
+    PixelW* getPixelsW(void);
+
+    /** @brief Set one framebuffer LED, see NeoLED::setPixel() */
+    neoled_err_t setPixel(uint16_t index, const Pixel& pixel);
+    neoled_err_t setPixel(uint16_t index, const PixelW& pixel);
+
+    /** @brief Send the framebuffer, see NeoLED::show() */
+    neoled_err_t show(void);
+#if NEOLED_ASYNC
+    neoled_err_t showAsync(void);
+#endif
+
+    /** @brief Set every LED to one colour, see NeoLED::fill() */
+    neoled_err_t fill(const Pixel& colour);
+
+    /** @brief Turn off all LEDs */
+    neoled_err_t clear(void);
+
+    /** @brief Release the I2S peripheral (buffers are kept for the next init) */
+    neoled_err_t destroy(void);
+
+    bool isInitialized(void) const;
+    uint16_t getLedCount(void) const;
+
+    void setBrightness(uint8_t brightness);
+    uint8_t getBrightness(void) const;
+
+    void setGamma(float gamma);
+    float getGamma(void) const;
+
+    void setAutoPrefix(bool enable);
+    bool getAutoPrefix(void) const;
+
+    /** @brief Cap the estimated frame current, see NeoLED::setPowerLimit() */
+    void setPowerLimit(uint16_t channel_ma, uint32_t limit_ma);
+    uint32_t getPowerLimit(void) const;
+    uint32_t getEstimatedCurrent(void) const;
+
+    /** @brief Set per-channel white balance and gamma, see NeoLED::setColorCorrection() */
+    neoled_err_t setColorCorrection(const neoled_color_correction_t* correction);
+    void getColorCorrection(neoled_color_correction_t* correction) const;
+
+    /** @brief Encode and send frames in chunks, see NeoLED::setStreaming() */
+    neoled_err_t setStreaming(uint16_t chunk_leds);
+    uint16_t getStreaming(void) const;
+    void getStreamStats(neoled_stream_stats_t* stats) const;
+
+    /** @brief Encode setPixel() straight into the frame buffer, see NeoLED::setEncodedFramebuffer() */
+    neoled_err_t setEncodedFramebuffer(bool enable);
+    bool getEncodedFramebuffer(void) const;
+
+#if NEOLED_RENDER
+    /** @brief Send frames from a render task, see NeoLED::startRender() */
+    neoled_err_t startRender(int core);
+    neoled_err_t stopRender(void);
+
+    /** @brief Draw and submit a frame to the render task, see NeoLED::acquireFrame() */
+    Pixel* acquireFrame(void);
+    PixelW* acquireFrameW(void);
+    neoled_err_t submitFrame(void);
+    uint32_t getDroppedFrames(void) const;
+#endif
+
+#if NEOLED_DITHER
+    /** @brief Enable temporal dithering, see NeoLED::setDithering() */
+    neoled_err_t setDithering(bool enable);
+    bool getDithering(void) const;
+
+    /** @brief Resend the last frame with the next dither step, see NeoLED::refresh() */
+    neoled_err_t refresh(void);
+
+#if NEOLED_RENDER
+    /** @brief Let the render task refresh a static frame, see NeoLED::setDitherRefresh() */
+    neoled_err_t setDitherRefresh(uint16_t interval_ms);
+    uint16_t getDitherRefresh(void) const;
+#endif
+#endif
+
+    neoled_err_t getDmaInfo(neoled_dma_info_t* info) const;
+    uint16_t getSkippedPixels(void) const;
+
+private:
+    Strip(const Strip&);
+    Strip& operator=(const Strip&);
+
+    StripState* state;
+};
+
+/**
+ * @brief Get the strip used by the free functions below
+ * @return Strip with LED_NUMBER LEDs
+ */
+Strip& defaultStrip(void);
+
+// ============================================================================
+// SPI Encoding
+// ============================================================================
+
+// SPI frame: every LED bit is three SPI bits, 100 for 0 and 110 for 1,
+// MSB first, so a pixel takes 9 bytes
+#define NEOLED_SPI_PIXEL_SIZE 9
+
+/**
+ * @brief Size of an SPI frame
+ * @param led_count Number of LEDs
+ * @return Bytes produced by encodeSpi(), including NEOLED_SPI_RESET_BYTES
+ */
+size_t spiFrameBytes(uint16_t led_count);
+
+/**
+ * @brief Encode pixels into an SPI frame (the encoder WS2812 spiBackend()
+ *        strips use)
+ * @param pixels Source pixel array
+ * @param led_count Number of pixels
+ * @param out Output buffer of spiFrameBytes(led_count) bytes
+ * @note No brightness or gamma is applied
+ */
+void encodeSpi(const Pixel* pixels, uint16_t led_count, uint8_t* out);
+
+// ============================================================================
+// Parallel Output
+// ============================================================================
+
+// Parallel sample stream: every WS2812 bit is three samples (high, data, low)
+// with lane n of the strip group on data line n
+#define NEOLED_PARALLEL_SLOTS 3
+
+/**
+ * @brief Size of the parallel sample stream for a group of strips
+ * @param lane_count Number of strips (8 or 16)
+ * @param led_count LEDs per strip
+ * @return Bytes produced by encodeParallel(), excluding reset samples
+ */
+size_t parallelFrameBytes(uint8_t lane_count, uint16_t led_count);
+
+/**
+ * @brief Interleave per-strip pixel arrays into a parallel sample stream
+ * @param lanes lane_count pixel arrays of led_count pixels (nullptr = LEDs off)
+ * @param lane_count Number of strips (8 or 16; one byte or 16-bit word per sample)
+ * @param led_count LEDs per strip
+ * @param out Output buffer of parallelFrameBytes(lane_count, led_count) bytes
+ * @note Transposes each 8x8 block of lane bits with word-wide shifts and masks
+ */
+void encodeParallel(const Pixel* const* lanes, uint8_t lane_count, uint16_t led_count, uint8_t* out);
+
+/**
+ * @brief Bit-by-bit reference for encodeParallel() (same output, much slower)
+ */
+void encodeParallelReference(const Pixel* const* lanes, uint8_t lane_count, uint16_t led_count, uint8_t* out);
+
+#if NEOLED_PARALLEL
+struct ParallelState;
+
+/**
+ * @brief Group of 8 or 16 equal-length strips driven from one peripheral in
+ *        LCD/parallel mode (esp_lcd i80 bus: I2S0 on ESP32, LCD_CAM on ESP32-S3)
+ */
+class ParallelStrip {
+public:
+    /**
+     * @brief Create a strip group (no hardware or buffers are touched until init)
+     * @param lane_count Number of strips (8 or 16)
+     * @param led_count LEDs per strip
+     */
+    ParallelStrip(uint8_t lane_count, uint16_t led_count);
+    ~ParallelStrip();
+
+    /**
+     * @brief Allocate the sample buffer and start the parallel bus
+     * @param gpio_pins lane_count data GPIOs, lane n on gpio_pins[n]
+     * @param clock_pin GPIO for the bus write strobe (not used by the LEDs)
+     * @return NEOLED_OK on success, error code otherwise
+     */
+    neoled_err_t init(const int* gpio_pins, int clock_pin);
+
+    /**
+     * @brief Encode all strips and start sending them
+     * @param lanes lane_count pixel arrays of getLedCount() pixels (nullptr = LEDs off)
+     * @return NEOLED_OK on success, error code otherwise
+     * @note Returns once the frame is queued; the next update waits for it
+     */
+    neoled_err_t update(const Pixel* const* lanes);
+
+    /** @brief Turn off all LEDs on all strips */
+    neoled_err_t clear(void);
+
+    /** @brief Stop the parallel bus (the sample buffer is kept for the next init) */
+    neoled_err_t destroy(void);
+
+    bool isInitialized(void) const;
+    uint8_t getLaneCount(void) const;
+    uint16_t getLedCount(void) const;
+
+    void setBrightness(uint8_t brightness);
+    uint8_t getBrightness(void) const;
+
+    void setGamma(float gamma);
+    float getGamma(void) const;
+
+private:
+    ParallelStrip(const ParallelStrip&);
+    ParallelStrip& operator=(const ParallelStrip&);
+
+    ParallelState* state;
+};
+#endif
+
+// ============================================================================
+// Core Functions (operate on defaultStrip())
 // ============================================================================
 
 /**
@@ -164,6 +733,67 @@ neoled_err_t init(void);
  */
 neoled_err_t initWithPin(int gpio_pin);
 
+/**
+ * @brief Initialize NeoLED with custom GPIO pin and peripheral
+ * @param gpio_pin GPIO pin number for data output
+ * @param port Backend peripheral instance (I2S port 0 to SOC_I2S_NUM - 1)
+ * @return NEOLED_OK on success, NEOLED_ERR_PARAM for an invalid port,
+ *         NEOLED_ERR_INIT if another strip already drives the port
+ * @note Strips on different ports are independent and may be updated
+ *       concurrently from different tasks
+ */
+neoled_err_t initWithPin(int gpio_pin, int port);
+
+/**
+ * @brief Select the output backend used by the next init
+ * @param backend Backend implementation (default: i2sBackend())
+ * @return NEOLED_OK on success, NEOLED_ERR_PARAM for nullptr,
+ *         NEOLED_ERR_INIT if the strip is initialized
+ */
+neoled_err_t setBackend(const neoled_backend_t* backend);
+
+/**
+ * @brief Get the output backend
+ * @return Backend used by the strip
+ */
+const neoled_backend_t* getBackend(void);
+
+/**
+ * @brief Select the LED chip protocol used by the next init
+ * @param protocol Chip protocol (default: NEOLED_WS2812)
+ * @return NEOLED_OK on success, NEOLED_ERR_PARAM for an unknown protocol,
+ *         NEOLED_ERR_INIT if the strip is initialized
+ * @note Each protocol has its own encoder, specialised at compile time for
+ *       its colour order; timing and reset length are folded into the
+ *       pipeline table and frame size, so the per-pixel loop never branches
+ *       on the protocol
+ */
+neoled_err_t setProtocol(neoled_protocol_t protocol);
+
+/**
+ * @brief Get the LED chip protocol
+ * @return Protocol used by the strip
+ */
+neoled_protocol_t getProtocol(void);
+
+/**
+ * @brief Override the colour order of the strip's protocol for the next init
+ * @param order Order the LEDs take their channels in (NEOLED_ORDER_DEFAULT
+ *        restores the protocol's own)
+ * @return NEOLED_OK on success, NEOLED_ERR_PARAM for an unknown order (or
+ *         one other than GRB and RGB without NEOLED_COLOR_ORDERS),
+ *         NEOLED_ERR_INIT if the strip is initialized
+ * @note Each of the six orders is its own encoder instance, so pixels stay in
+ *       the Pixel layout and no per-pixel swizzle pass is needed
+ */
+neoled_err_t setColorOrder(neoled_color_order_t order);
+
+/**
+ * @brief Get the colour order the strip sends
+ * @return The override, or the protocol's own order
+ */
+neoled_color_order_t getColorOrder(void);
+
 /**
  * @brief Update LED strip with pixel data
  * @param pixels Pointer to pixel array
@@ -179,9 +809,160 @@ neoled_err_t update(const Pixel* pixels);
  */
 neoled_err_t updateWithBrightness(const Pixel* pixels, uint8_t brightness);
 
+/**
+ * @brief Update an RGBW strip with pixel data
+ * @param pixels Pointer to RGBW pixel array
+ * @return NEOLED_OK on success, NEOLED_ERR_PARAM if the strip's protocol has
+ *         no white channel
+ * @note Needs a four-channel protocol (NEOLED_SK6812_RGBW), which also
+ *       accepts Pixel arrays with the white channel off. Each channel goes
+ *       through the same brightness and gamma table.
+ */
+neoled_err_t update(const PixelW* pixels);
+
+/**
+ * @brief Update an RGBW strip with pixel data and brightness adjustment
+ * @param pixels Pointer to RGBW pixel array
+ * @param brightness Global brightness (0-255)
+ * @return NEOLED_OK on success, error code otherwise
+ */
+neoled_err_t updateWithBrightness(const PixelW* pixels, uint8_t brightness);
+
+#if NEOLED_PIXEL16
+/**
+ * @brief Update the strip from 16-bit pixel data
+ * @param pixels Pointer to 16-bit pixel array
+ * @return NEOLED_OK on success, error code otherwise
+ * @note Brightness and gamma are applied in the encode pass, with no 8-bit
+ *       copy of the array. Without dithering each channel is rounded to the
+ *       nearest 8-bit value; with setDithering() the full 16 bits set the
+ *       dithered level. Works on RGBW strips with the white channel off.
+ */
+neoled_err_t update(const Pixel16* pixels);
+
+/**
+ * @brief Update from 16-bit pixel data with brightness adjustment
+ * @param pixels Pointer to 16-bit pixel array
+ * @param brightness Global brightness (0-255)
+ * @return NEOLED_OK on success, error code otherwise
+ */
+neoled_err_t updateWithBrightness(const Pixel16* pixels, uint8_t brightness);
+#endif
+
+/**
+ * @brief Update and send only the first count LEDs
+ * @param pixels Pointer to pixel array (at least count pixels)
+ * @param count Number of leading LEDs to update (1-LED_NUMBER)
+ * @return NEOLED_OK on success, error code otherwise
+ * @note LEDs past count are not clocked out and keep their latched colour,
+ *       so the frame takes count * PIXEL_SIZE bytes of wire time
+ */
+neoled_err_t updateRange(const Pixel* pixels, uint16_t count);
+
+#if NEOLED_ASYNC
+/**
+ * @brief Encode a frame and queue it for sending without waiting for the wire
+ * @param pixels Pointer to pixel array
+ * @return NEOLED_OK on success, error code otherwise
+ * @note Frames are double-buffered: the call only blocks if the frame before
+ *       the previous one is still queued or on the wire. The pixel array may
+ *       be reused as soon as this returns. Call from one task only.
+ */
+neoled_err_t updateAsync(const Pixel* pixels);
+
+/**
+ * @brief Queue an RGBW frame, see updateAsync(const Pixel*) and update(const PixelW*)
+ */
+neoled_err_t updateAsync(const PixelW* pixels);
+
+#if NEOLED_PIXEL16
+/**
+ * @brief Queue a 16-bit frame, see updateAsync(const Pixel*) and update(const Pixel16*)
+ */
+neoled_err_t updateAsync(const Pixel16* pixels);
+#endif
+
+/**
+ * @brief Wait until all frames queued by updateAsync() have been sent
+ * @param timeout_ms Maximum time to wait in milliseconds (UINT32_MAX = forever)
+ * @return NEOLED_OK when idle, NEOLED_ERR_TIMEOUT on timeout
+ */
+neoled_err_t waitForUpdate(uint32_t timeout_ms);
+
+/**
+ * @brief Set the callback invoked after each updateAsync() frame is sent
+ * @param callback Callback function, nullptr to disable
+ * @param user_data Pointer passed to the callback
+ */
+void setUpdateCallback(neoled_update_cb_t callback, void* user_data);
+#endif
+
+/**
+ * @brief Get a writable view of the framebuffer the library owns
+ * @return LED_NUMBER pixels, allocated (all off) on first use, or NULL if
+ *         the protocol takes RGBW pixels or allocation failed
+ * @note Effects draw into the array in place and call show(); no copy of
+ *       the frame is kept outside the library. The array stays valid until
+ *       the protocol changes to one with a different pixel size. Writes
+ *       through the pointer cannot be tracked, so once it has been handed
+ *       out every show() compares the whole frame; use setPixel() alone to
+ *       keep show() proportional to the LEDs changed.
+ */
+Pixel* getPixels(void);
+
+/**
+ * @brief Get the framebuffer of an RGBW strip, see getPixels()
+ * @return LED_NUMBER pixels, or NULL if the protocol takes RGB pixels
+ */
+PixelW* getPixelsW(void);
+
+/**
+ * @brief Set one LED in the framebuffer without sending it
+ * @param index LED index (0 to LED_NUMBER-1)
+ * @param pixel Colour (white is 0 on an RGBW strip)
+ * @return NEOLED_OK on success, NEOLED_ERR_PARAM if index is out of range,
+ *         NEOLED_ERR_NO_MEM if the framebuffer could not be allocated
+ * @note The highest LED set is recorded, so show() only encodes up to it
+ *       (with NEOLED_DIRTY_TRACKING)
+ */
+neoled_err_t setPixel(uint16_t index, const Pixel& pixel);
+
+/**
+ * @brief Set one LED of an RGBW strip, see setPixel(uint16_t, const Pixel&)
+ * @return NEOLED_ERR_PARAM also if the protocol takes RGB pixels
+ */
+neoled_err_t setPixel(uint16_t index, const PixelW& pixel);
+
+/**
+ * @brief Encode and send the framebuffer with the strip brightness
+ * @return NEOLED_OK on success, error code otherwise
+ * @note Same output as update() with a copy of the framebuffer. clear() and
+ *       update() with another array leave the framebuffer unchanged.
+ */
+neoled_err_t show(void);
+
+#if NEOLED_ASYNC
+/**
+ * @brief Encode the framebuffer and queue it, see show() and updateAsync()
+ * @return NEOLED_OK on success, error code otherwise
+ */
+neoled_err_t showAsync(void);
+#endif
+
+/**
+ * @brief Set every LED to one colour and send the frame
+ * @param colour Colour for all LEDs (white is 0 on an RGBW strip)
+ * @return NEOLED_OK on success, error code otherwise
+ * @note No pixel array is needed: the colour is encoded once and copied
+ *       across the frame buffer. The framebuffer of getPixels() is left
+ *       unchanged.
+ */
+neoled_err_t fill(const Pixel& colour);
+
 /**
  * @brief Turn off all LEDs
  * @return NEOLED_OK on success, error code otherwise
+ * @note Same as fill(COLOR_OFF); allocates nothing
  */
 neoled_err_t clear(void);
 
@@ -209,6 +990,261 @@ void setBrightness(uint8_t brightness);
  */
 uint8_t getBrightness(void);
 
+/**
+ * @brief Enable or disable automatic prefix-only transmission
+ * @param enable true to stop each frame after the last changed LED
+ * @note Requires NEOLED_DIRTY_TRACKING. LEDs after the highest changed index
+ *       keep their latched colour; a frame with no changes sends nothing.
+ */
+void setAutoPrefix(bool enable);
+
+/**
+ * @brief Check whether automatic prefix-only transmission is enabled
+ * @return true if enabled
+ */
+bool getAutoPrefix(void);
+
+/**
+ * @brief Get the DMA layout and memory footprint chosen for the strip
+ * @param info Receives the descriptor count, size and total DMA memory
+ * @return NEOLED_OK on success, error code otherwise
+ */
+neoled_err_t getDmaInfo(neoled_dma_info_t* info);
+
+/**
+ * @brief Get the number of pixels whose encoding was reused in the last update
+ * @return Unchanged pixels skipped by dirty tracking (0 if disabled)
+ */
+uint16_t getSkippedPixels(void);
+
+/**
+ * @brief Set the gamma curve applied by the driver during encoding
+ * @param gamma Gamma value (1.0 = linear/off, default; typically 2.2-2.8)
+ * @note Brightness, gamma and the bit encoding are folded into one lookup
+ *       table that is only rebuilt when one of them changes, so pixels do not
+ *       need a separate gammaCorrect() pass
+ */
+void setGamma(float gamma);
+
+/**
+ * @brief Get the gamma curve applied by the driver
+ * @return Current gamma value
+ */
+float getGamma(void);
+
+/**
+ * @brief Cap the current a frame may draw by lowering its brightness
+ * @param channel_ma Current of one LED channel at full level (typically 20 mA
+ *        for WS2812, NEOLED_CHANNEL_MA by default)
+ * @param limit_ma Supply budget for the strip in mA, 0 for no limit
+ * @note The estimate is the sum of the gamma-corrected channel levels, times
+ *       brightness and channel_ma. Levels do not depend on brightness, so the
+ *       sum is taken before encoding (under dirty tracking, from the pixels
+ *       that changed only) and each frame is encoded once. A frame over
+ *       budget is sent at the highest brightness that fits; the LEDs' idle
+ *       current is not counted.
+ */
+void setPowerLimit(uint16_t channel_ma, uint32_t limit_ma);
+
+/**
+ * @brief Get the supply budget set by setPowerLimit()
+ * @return Budget in mA, 0 if there is no limit
+ */
+uint32_t getPowerLimit(void);
+
+/**
+ * @brief Get the estimated current of the last frame, after any limiting
+ * @return Estimated current in mA
+ */
+uint32_t getEstimatedCurrent(void);
+
+/**
+ * @brief Set per-channel colour correction
+ * @param correction White balance scale and gamma of each channel, or NULL to
+ *        remove the correction
+ * @return NEOLED_OK on success, NEOLED_ERR_PARAM for a negative gamma,
+ *         NEOLED_ERR_NO_MEM if the channel tables could not be allocated
+ * @note Each channel gets its own lookup tables with gamma, white balance and
+ *       brightness folded in, so the encode loop costs the same as without
+ *       correction. A correction with every scale at 255 and every gamma at 0
+ *       frees the tables (about 5 KB, 7 KB with NEOLED_DITHER). The power
+ *       estimate uses the corrected levels.
+ */
+neoled_err_t setColorCorrection(const neoled_color_correction_t* correction);
+
+/**
+ * @brief Get the colour correction set by setColorCorrection()
+ * @param correction Receives the correction (scales 255 and gammas 0 if none)
+ */
+void getColorCorrection(neoled_color_correction_t* correction);
+
+/**
+ * @brief Encode and send frames a chunk at a time instead of whole
+ * @param chunk_leds LEDs per chunk, 0 for whole-frame buffers (default)
+ * @return NEOLED_OK on success, NEOLED_ERR_INIT while initialized
+ * @note Call before init(). Each chunk is encoded into one small buffer and
+ *       written as soon as the DMA ring has room, while the previous chunks
+ *       drain. Memory is one chunk plus NEOLED_STREAM_DEPTH chunks of DMA
+ *       buffers, whatever the LED count. Every frame is encoded in full:
+ *       dirty tracking and auto prefix have no effect, and updateAsync() and
+ *       dithering are not available. Needs a backend that sends the reset in
+ *       the frame (I2S or SPI). Encoding must keep up with the wire, see
+ *       getStreamStats().
+ */
+neoled_err_t setStreaming(uint16_t chunk_leds);
+
+/**
+ * @brief Get the chunk size set by setStreaming()
+ * @return LEDs per chunk, 0 if not streaming
+ */
+uint16_t getStreaming(void);
+
+/**
+ * @brief Get the chunk encode times of a streaming strip
+ * @param stats Receives the longest chunk encode of the last frame, the time
+ *        the DMA ring covers, and the number of underruns since init
+ * @note An underrun is a chunk that took longer to encode than the queued
+ *       chunks take to send. The line then goes low mid-frame, and if that
+ *       lasts longer than the reset time the LEDs latch a partial frame. Use
+ *       larger chunks, a deeper NEOLED_STREAM_DEPTH or a higher task priority.
+ */
+void getStreamStats(neoled_stream_stats_t* stats);
+
+/**
+ * @brief Make setPixel() encode straight into the frame buffer
+ * @param enable true for encoded framebuffer mode, false for the pixel framebuffer
+ * @return NEOLED_OK on success, NEOLED_ERR_PARAM while streaming or dithering,
+ *         or with a power limit set
+ * @note In this mode there is no Pixel array: setPixel() encodes the LED
+ *       into the buffer that is sent next, at the strip brightness, and
+ *       show() only sends that buffer. Setting one LED costs the same
+ *       whatever the strip length, and with auto prefix show() stops after
+ *       the highest LED set. setPixel() needs an initialized strip.
+ *       update() and clear() still encode into the same buffer, so
+ *       setPixel() edits whatever they sent. LEDs are never re-encoded, so
+ *       the encoding is fixed while the mode is on: setBrightness(),
+ *       setGamma() and a nonzero setPowerLimit() are ignored (and logged),
+ *       setColorCorrection() returns NEOLED_ERR_PARAM. Set them before
+ *       enabling the mode. getPixels(), showAsync() and updateAsync() are
+ *       refused.
+ */
+neoled_err_t setEncodedFramebuffer(bool enable);
+
+/**
+ * @brief Check whether encoded framebuffer mode is on
+ * @return true if setPixel() encodes straight into the frame buffer
+ */
+bool getEncodedFramebuffer(void);
+
+#if NEOLED_RENDER
+/**
+ * @brief Start a task that encodes and sends the frames given to submitFrame()
+ * @param core Core to pin the task to, or tskNO_AFFINITY
+ * @return NEOLED_OK on success, NEOLED_ERR_NOT_INIT before init,
+ *         NEOLED_ERR_INIT if already running, NEOLED_ERR_NO_MEM on allocation
+ *         failure
+ * @note The task runs at NEOLED_TASK_PRIORITY. Three frames of pixels are
+ *       allocated, handed between one producer task and the render task
+ *       without locks. While it runs, the render task is the only sender:
+ *       update(), show(), fill() and clear() return NEOLED_ERR_PARAM.
+ *       The settings the task reads for each frame are fixed until
+ *       stopRender(): setBrightness(), setGamma(), setPowerLimit() and
+ *       setAutoPrefix() are ignored (and logged), setColorCorrection(),
+ *       setDithering() and setDitherRefresh() return NEOLED_ERR_PARAM.
+ */
+neoled_err_t startRender(int core);
+
+/**
+ * @brief Send the last submitted frame and stop the render task
+ * @return NEOLED_OK
+ * @note destroy() stops the task too
+ */
+neoled_err_t stopRender(void);
+
+/**
+ * @brief Get the frame to draw into before submitFrame()
+ * @return LED_NUMBER pixels, or NULL if the render task is not running or the
+ *         protocol takes RGBW pixels
+ * @note The frame holds an older picture, so draw every LED. Call from one
+ *       producer task only, and call again after each submitFrame().
+ */
+Pixel* acquireFrame(void);
+
+/**
+ * @brief Get the frame of an RGBW strip, see acquireFrame()
+ * @return LED_NUMBER pixels, or NULL if the protocol takes RGB pixels
+ */
+PixelW* acquireFrameW(void);
+
+/**
+ * @brief Hand the acquired frame to the render task
+ * @return NEOLED_OK, NEOLED_ERR_NOT_INIT if the render task is not running
+ * @note Never waits for the wire. The latest frame wins: a frame the task has
+ *       not started on when the next one is submitted is dropped, so frames
+ *       never queue up behind a slow strip.
+ */
+neoled_err_t submitFrame(void);
+
+/**
+ * @brief Get the number of submitted frames replaced before they were sent
+ * @return Frames dropped since startRender()
+ */
+uint32_t getDroppedFrames(void);
+#endif
+
+#if NEOLED_DITHER
+/**
+ * @brief Enable or disable temporal dithering
+ * @param enable true to dither brightness and gamma below one output step
+ * @return NEOLED_OK on success, NEOLED_ERR_NO_MEM if the pixel copy could not
+ *         be allocated
+ * @note Brightness and gamma are kept in 8.8 fixed point and each frame rounds
+ *       up or down following a 16-step ordered sequence, offset per LED, so the
+ *       average over 16 frames has about 12 bits per channel. Every frame
+ *       re-encodes every LED (dirty tracking and auto prefix have no effect);
+ *       call refresh() when there is no new frame to keep the sequence running,
+ *       or let the render task do it, see setDitherRefresh(). Enabled after
+ *       frames were sent, dithering starts from the frame on the LEDs (with
+ *       NEOLED_DIRTY_TRACKING; otherwise refresh() waits for the next frame).
+ */
+neoled_err_t setDithering(bool enable);
+
+/**
+ * @brief Check whether temporal dithering is enabled
+ * @return true if enabled
+ */
+bool getDithering(void);
+
+/**
+ * @brief Send the last frame again with the next dither step
+ * @return NEOLED_OK on success, NEOLED_ERR_PARAM if dithering is off or no
+ *         frame is known since it was enabled
+ * @note Uses the brightness of the last frame. Call at the frame rate while the
+ *       picture is static; the dither only averages out while frames keep going.
+ */
+neoled_err_t refresh(void);
+
+#if NEOLED_RENDER
+/**
+ * @brief Have the render task refresh a static frame while dithering
+ * @param interval_ms Longest gap between frames, 0 (default) to refresh only
+ *        when a frame is submitted
+ * @return NEOLED_OK on success, NEOLED_ERR_PARAM while the render task runs
+ * @note With dithering on and the render task running, the task sends the last
+ *       frame again with the next dither step whenever no new frame has been
+ *       submitted for interval_ms, so a static picture needs no refresh() calls.
+ *       Use about the wire time of a frame (9.3 ms for 300 WS2812 LEDs).
+ */
+neoled_err_t setDitherRefresh(uint16_t interval_ms);
+
+/**
+ * @brief Get the render task's dither refresh interval
+ * @return Interval in milliseconds, 0 if off
+ */
+uint16_t getDitherRefresh(void);
+#endif
+#endif
+
 // ============================================================================
 // Pixel Creation Functions (Inline for performance)
 // ============================================================================
@@ -415,6 +1451,22 @@ inline Pixel blend(const Pixel& a, const Pixel& b, uint8_t blendAmount)
  */
 Pixel gammaCorrect(const Pixel& pixel, float gamma = 2.2f);
 
+/**
+ * @brief Convert an array of RGB pixels to RGBW
+ * @param pixels Source pixel array
+ * @param out Output array of count RGBW pixels
+ * @param count Number of pixels
+ * @param mode White extraction (NEOLED_WHITE_MIN moves the grey part of each
+ *        colour to white, NEOLED_WHITE_TEMPERATURE the part matching a white
+ *        LED of white_kelvin)
+ * @param white_kelvin Colour temperature of the white LED (2000-10000 K,
+ *        NEOLED_WHITE_TEMPERATURE only)
+ * @note One branch-free pass over the array; the white point is worked out
+ *       once per call
+ */
+void rgbToRgbw(const Pixel* pixels, PixelW* out, uint16_t count,
+               neoled_white_mode_t mode, uint16_t white_kelvin = 4500);
+
 } // namespace NeoLED
 
 #endif // NEOLED_H
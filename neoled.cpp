@@ -22,14 +22,22 @@
 
 */
 
+#include <atomic>
 #include <cmath>
 #include <cstdio>
 #include <cstring>
+#include <new>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
 #include "esp_system.h"
+#include "esp_attr.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
 #include "driver/gpio.h"
+#include "soc/soc_caps.h"
 #include "neoled.h"
 
 // ESP-IDF version-specific includes
@@ -41,6 +49,25 @@
     #include "driver/i2s.h"
 #endif
 
+#if NEOLED_RMT
+    // RMT output backend
+    #if NEOLED_USE_NEW_I2S_DRIVER
+        #include "driver/rmt_tx.h"
+    #else
+        #include "driver/rmt.h"
+    #endif
+#endif
+
+#if NEOLED_SPI
+    // SPI output backend
+    #include "driver/spi_master.h"
+#endif
+
+#if NEOLED_PARALLEL
+    // LCD/parallel mode via the esp_lcd i80 bus
+    #include "esp_lcd_panel_io.h"
+#endif
+
 static const char* TAG = "NeoLED";
 
 namespace NeoLED {
@@ -49,26 +76,294 @@ namespace NeoLED {
 // Static Variables
 // ============================================================================
 
-static uint8_t out_buffer[LED_NUMBER * PIXEL_SIZE] = {0};
-static uint8_t off_buffer[ZERO_BUFFER] = {0};
-static uint16_t size_buffer = 0;
-static bool initialized = false;
-static uint8_t global_brightness = 255;
-static int current_gpio_pin = I2S_DO_IO;
-
 // Bit patterns for WS2812 timing via I2S
 static const uint16_t bitpatterns[4] = {0x88, 0x8e, 0xe8, 0xee};
 
+#if NEOLED_ENCODER_LUT
+// Byte-to-word lookup table: each entry holds the four bitpatterns[] bytes for
+// one colour byte, packed little-endian so a single 32-bit store writes them
+// in the same order as the 2-bit encoder (bits 7-6 land in the lowest byte)
+static const uint32_t byte_patterns[256] = {
+    0x88888888, 0x8e888888, 0xe8888888, 0xee888888, 0x888e8888, 0x8e8e8888, 0xe88e8888, 0xee8e8888,
+    0x88e88888, 0x8ee88888, 0xe8e88888, 0xeee88888, 0x88ee8888, 0x8eee8888, 0xe8ee8888, 0xeeee8888,
+    0x88888e88, 0x8e888e88, 0xe8888e88, 0xee888e88, 0x888e8e88, 0x8e8e8e88, 0xe88e8e88, 0xee8e8e88,
+    0x88e88e88, 0x8ee88e88, 0xe8e88e88, 0xeee88e88, 0x88ee8e88, 0x8eee8e88, 0xe8ee8e88, 0xeeee8e88,
+    0x8888e888, 0x8e88e888, 0xe888e888, 0xee88e888, 0x888ee888, 0x8e8ee888, 0xe88ee888, 0xee8ee888,
+    0x88e8e888, 0x8ee8e888, 0xe8e8e888, 0xeee8e888, 0x88eee888, 0x8eeee888, 0xe8eee888, 0xeeeee888,
+    0x8888ee88, 0x8e88ee88, 0xe888ee88, 0xee88ee88, 0x888eee88, 0x8e8eee88, 0xe88eee88, 0xee8eee88,
+    0x88e8ee88, 0x8ee8ee88, 0xe8e8ee88, 0xeee8ee88, 0x88eeee88, 0x8eeeee88, 0xe8eeee88, 0xeeeeee88,
+    0x8888888e, 0x8e88888e, 0xe888888e, 0xee88888e, 0x888e888e, 0x8e8e888e, 0xe88e888e, 0xee8e888e,
+    0x88e8888e, 0x8ee8888e, 0xe8e8888e, 0xeee8888e, 0x88ee888e, 0x8eee888e, 0xe8ee888e, 0xeeee888e,
+    0x88888e8e, 0x8e888e8e, 0xe8888e8e, 0xee888e8e, 0x888e8e8e, 0x8e8e8e8e, 0xe88e8e8e, 0xee8e8e8e,
+    0x88e88e8e, 0x8ee88e8e, 0xe8e88e8e, 0xeee88e8e, 0x88ee8e8e, 0x8eee8e8e, 0xe8ee8e8e, 0xeeee8e8e,
+    0x8888e88e, 0x8e88e88e, 0xe888e88e, 0xee88e88e, 0x888ee88e, 0x8e8ee88e, 0xe88ee88e, 0xee8ee88e,
+    0x88e8e88e, 0x8ee8e88e, 0xe8e8e88e, 0xeee8e88e, 0x88eee88e, 0x8eeee88e, 0xe8eee88e, 0xeeeee88e,
+    0x8888ee8e, 0x8e88ee8e, 0xe888ee8e, 0xee88ee8e, 0x888eee8e, 0x8e8eee8e, 0xe88eee8e, 0xee8eee8e,
+    0x88e8ee8e, 0x8ee8ee8e, 0xe8e8ee8e, 0xeee8ee8e, 0x88eeee8e, 0x8eeeee8e, 0xe8eeee8e, 0xeeeeee8e,
+    0x888888e8, 0x8e8888e8, 0xe88888e8, 0xee8888e8, 0x888e88e8, 0x8e8e88e8, 0xe88e88e8, 0xee8e88e8,
+    0x88e888e8, 0x8ee888e8, 0xe8e888e8, 0xeee888e8, 0x88ee88e8, 0x8eee88e8, 0xe8ee88e8, 0xeeee88e8,
+    0x88888ee8, 0x8e888ee8, 0xe8888ee8, 0xee888ee8, 0x888e8ee8, 0x8e8e8ee8, 0xe88e8ee8, 0xee8e8ee8,
+    0x88e88ee8, 0x8ee88ee8, 0xe8e88ee8, 0xeee88ee8, 0x88ee8ee8, 0x8eee8ee8, 0xe8ee8ee8, 0xeeee8ee8,
+    0x8888e8e8, 0x8e88e8e8, 0xe888e8e8, 0xee88e8e8, 0x888ee8e8, 0x8e8ee8e8, 0xe88ee8e8, 0xee8ee8e8,
+    0x88e8e8e8, 0x8ee8e8e8, 0xe8e8e8e8, 0xeee8e8e8, 0x88eee8e8, 0x8eeee8e8, 0xe8eee8e8, 0xeeeee8e8,
+    0x8888eee8, 0x8e88eee8, 0xe888eee8, 0xee88eee8, 0x888eeee8, 0x8e8eeee8, 0xe88eeee8, 0xee8eeee8,
+    0x88e8eee8, 0x8ee8eee8, 0xe8e8eee8, 0xeee8eee8, 0x88eeeee8, 0x8eeeeee8, 0xe8eeeee8, 0xeeeeeee8,
+    0x888888ee, 0x8e8888ee, 0xe88888ee, 0xee8888ee, 0x888e88ee, 0x8e8e88ee, 0xe88e88ee, 0xee8e88ee,
+    0x88e888ee, 0x8ee888ee, 0xe8e888ee, 0xeee888ee, 0x88ee88ee, 0x8eee88ee, 0xe8ee88ee, 0xeeee88ee,
+    0x88888eee, 0x8e888eee, 0xe8888eee, 0xee888eee, 0x888e8eee, 0x8e8e8eee, 0xe88e8eee, 0xee8e8eee,
+    0x88e88eee, 0x8ee88eee, 0xe8e88eee, 0xeee88eee, 0x88ee8eee, 0x8eee8eee, 0xe8ee8eee, 0xeeee8eee,
+    0x8888e8ee, 0x8e88e8ee, 0xe888e8ee, 0xee88e8ee, 0x888ee8ee, 0x8e8ee8ee, 0xe88ee8ee, 0xee8ee8ee,
+    0x88e8e8ee, 0x8ee8e8ee, 0xe8e8e8ee, 0xeee8e8ee, 0x88eee8ee, 0x8eeee8ee, 0xe8eee8ee, 0xeeeee8ee,
+    0x8888eeee, 0x8e88eeee, 0xe888eeee, 0xee88eeee, 0x888eeeee, 0x8e8eeeee, 0xe88eeeee, 0xee8eeeee,
+    0x88e8eeee, 0x8ee8eeee, 0xe8e8eeee, 0xeee8eeee, 0x88eeeeee, 0x8eeeeeee, 0xe8eeeeee, 0xeeeeeeee
+};
+#endif
+
+// Gamma correction lookup table (gamma = 2.2)
+static const uint8_t gamma22_table[256] = {
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,
+    1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+    2,   3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   5,   5,   5,
+    5,   6,   6,   6,   6,   7,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,
+   10,  10,  11,  11,  11,  12,  12,  13,  13,  13,  14,  14,  15,  15,  16,  16,
+   17,  17,  18,  18,  19,  19,  20,  20,  21,  21,  22,  22,  23,  24,  24,  25,
+   25,  26,  27,  27,  28,  29,  29,  30,  31,  32,  32,  33,  34,  35,  35,  36,
+   37,  38,  39,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  50,
+   51,  52,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  66,  67,  68,
+   69,  70,  72,  73,  74,  75,  77,  78,  79,  81,  82,  83,  85,  86,  87,  89,
+   90,  92,  93,  95,  96,  98,  99, 101, 102, 104, 105, 107, 109, 110, 112, 114,
+  115, 117, 119, 120, 122, 124, 126, 127, 129, 131, 133, 135, 137, 138, 140, 142,
+  144, 146, 148, 150, 152, 154, 156, 158, 160, 162, 164, 167, 169, 171, 173, 175,
+  177, 180, 182, 184, 186, 189, 191, 193, 196, 198, 200, 203, 205, 208, 210, 213,
+  215, 218, 220, 223, 225, 228, 231, 233, 236, 239, 241, 244, 247, 249, 252, 255
+};
+
+
+// Encoded frame buffers per strip: two with NEOLED_ASYNC so one can be encoded
+// while the other is on the wire. I2S and SPI frames end with their reset
+// bytes so a frame and its latch go out in a single write.
+#define NEOLED_BUFFER_COUNT (NEOLED_ASYNC ? 2 : 1)
+
+static const uint32_t I2S_SAMPLE_BYTES = 4;  // 16-bit stereo sample frame
+
+#if NEOLED_ASYNC
+// Frame handed from updateAsync() to the writer task
+typedef struct {
+    uint8_t buffer;   // Index into out_buffers, WRITER_STOP to exit
+    uint16_t count;   // Leading LEDs to send
+} FrameJob;
+
+static const uint8_t WRITER_STOP = 0xFF;
+#endif
+
+// ============================================================================
+// Strip State
+// ============================================================================
+
+/**
+ * @brief LED protocol parameters for one chip, built from its ProtocolTraits
+ */
+typedef struct {
+    uint8_t channels;         // Colour channels per LED (3, or 4 for RGBW)
+    uint32_t t0h_ns;          // High time of a 0 bit
+    uint32_t t1h_ns;          // High time of a 1 bit
+    uint32_t bit_ns;          // Bit period
+    uint32_t reset_us;        // Latch time
+    uint32_t sample_rate;     // I2S: four slots of 1 / (32 x sample_rate) per bit
+    uint8_t one_slots;        // I2S: slots high in a 1 bit (a 0 bit is one slot)
+    size_t i2s_reset_bytes;   // I2S: reset samples at the end of a frame
+    uint32_t spi_clock_hz;    // SPI: three SPI bits per LED bit
+    size_t spi_reset_bytes;   // SPI: reset bytes at the end of a frame
+    neoled_color_order_t order;  // Chip's colour order
+} ProtocolInfo;
+
+/**
+ * @brief Colour pipeline tables of each channel, indexed by CHANNEL_RED to
+ *        CHANNEL_WHITE; without colour correction all point at one table
+ */
+typedef struct {
+    const uint32_t* encode[4];  // Encoded word of each colour value
+    const uint8_t* level[4];    // Corrected level of each colour value, for the power estimate
+#if NEOLED_DITHER
+    const uint16_t* dither[4];  // 8.8 output level of each colour value
+#endif
+} ChannelTables;
+
+/**
+ * @brief Per-channel tables, allocated while colour correction is set
+ */
+typedef struct {
+    uint16_t curve[4][256];
+    uint32_t encode[4][256];
+    uint8_t level[4][256];
+#if NEOLED_DITHER
+    uint16_t dither[4][257];
+#endif
+} CorrectionTables;
+
+/**
+ * @brief Per-strip driver state, owned by a Strip
+ */
+struct StripState {
+    uint16_t led_count;
+    size_t frame_bytes;     // Encoded LEDs plus reset samples
+    size_t buffer_stride;   // frame_bytes rounded up to whole words
+    size_t pixel_bytes;     // Bytes per LED in the backend's frame format
+    size_t reset_bytes;     // Reset samples carried in the frame itself
+    bool initialized;
+    int gpio_pin;
+    int port;               // Peripheral instance handed to the backend
+    neoled_protocol_t protocol;
+    const ProtocolInfo* protocol_info;
+    neoled_color_order_t color_order;  // NEOLED_ORDER_DEFAULT = the protocol's
+
+    // Output backend and its per-strip handle while initialized
+    const neoled_backend_t* backend;
+    void* backend_handle;
+
+    // Encoded frame buffers, allocated once from DMA-capable memory
+    uint8_t* out_buffers[NEOLED_BUFFER_COUNT];
+    int active_buffer;      // Buffer holding the most recently encoded frame
+    uint8_t* reset_save;    // Bytes a prefix's reset displaces, see transmit()
+
+    // Encoders specialised for the protocol's colour order and the backend's
+    // frame format, chosen by applyFrameFormat()
+    uint16_t (*encode_range)(StripState* s, int buffer, const Pixel* pixels, uint16_t count);
+    uint16_t (*encode_range_w)(StripState* s, int buffer, const PixelW* pixels, uint16_t count);  // NULL without white
+#if NEOLED_PIXEL16
+    uint16_t (*encode_range16)(StripState* s, int buffer, const Pixel16* pixels, uint16_t count);
+#endif
+    void (*encode_solid)(StripState* s, int buffer, const Pixel& colour, uint16_t count);
+    void (*encode_pixel)(StripState* s, int buffer, uint16_t index, const Pixel& pixel);
+    void (*encode_pixel_w)(StripState* s, int buffer, uint16_t index, const PixelW& pixel);  // NULL without white
+
+    // Colour pipeline table: brightness, gamma and bit encoding folded into
+    // one encoded word per colour value, rebuilt only when its inputs change
+    uint8_t brightness;
+    float gamma;
+    uint32_t pipeline_table[256];
+    bool pipeline_valid;
+    uint8_t pipeline_brightness;
+    ChannelTables tables;       // Tables the encoders use, set by preparePipeline()
+
+    // Gamma curve of each colour value in 8.8 fixed point, the source of the
+    // tables above; rebuilt only when gamma or colour correction change
+    uint16_t curve_table[256];
+    bool curve_valid;
+    float curve_gamma;
+
+    // Colour correction: white balance and gamma per channel (CHANNEL_RED to
+    // CHANNEL_WHITE) folded into per-channel copies of the tables
+    uint8_t correction_scale[4];
+    float correction_gamma[4];  // 0 = the strip's gamma
+    CorrectionTables* correction_tables;  // NULL without colour correction
+
+    // Power limiter: gamma-corrected channel levels are summed before each
+    // frame is encoded and scaled by brightness and channel_ma into a current
+    uint8_t level_table[256];   // Gamma-corrected level of each colour value
+    uint32_t frame_levels;      // Sum of levels over the last frame encoded
+    uint32_t frame_current_ma;  // Estimated current of the last frame encoded
+    uint16_t channel_ma;        // Current of one channel at full level
+    uint32_t power_limit_ma;    // Supply budget, 0 = no limit
+
+#if NEOLED_DITHER
+    // Temporal dithering: dither_table holds brightness and gamma in 8.8 fixed
+    // point and pipeline_table only the bit encoding of each output value
+    bool dithering;
+    bool pipeline_dither;
+    uint16_t dither_table[257];  // Last entry repeats 255 for interpolation
+    uint8_t dither_step;      // Advanced once per dithered frame
+    uint8_t* dither_pixels;   // Last pixels sent as DitherSource, for refresh()
+    bool dither_seeded;       // dither_pixels holds the frame on the LEDs
+    uint16_t dither_refresh_ms;  // Render task refresh of a static frame, 0 = off
+#endif
+
+#if NEOLED_DIRTY_TRACKING
+    // Last pixel values encoded into each buffer, used to skip unchanged
+    // pixels (Pixel or PixelW, one byte per protocol channel)
+    uint8_t* shown_pixels[NEOLED_BUFFER_COUNT];
+    bool shown_valid[NEOLED_BUFFER_COUNT];
+    uint32_t shown_levels[NEOLED_BUFFER_COUNT];  // Sum of levels in shown_pixels
+#endif
+    uint16_t skipped_pixels;
+    bool auto_prefix;
+
+    // Driver-owned pixels for getPixels()/show(), one byte per protocol channel
+    uint8_t* framebuffer;       // NULL until first used
+    bool framebuffer_shared;    // getPixels() handed out the array, writes are not seen
+#if NEOLED_DIRTY_TRACKING
+    // One past the last LED setPixel() changed since the framebuffer was last
+    // encoded into each buffer (led_count if the buffer holds something else)
+    uint16_t framebuffer_dirty_end[NEOLED_BUFFER_COUNT];
+#endif
+
+    // Encoded framebuffer mode: setPixel() encodes straight into the active
+    // buffer and show() only sends it
+    bool encoded_framebuffer;
+    uint16_t encoded_dirty_end;  // One past the last LED set since show()
+
+    // DMA layout derived from the encoded frame length at init
+    uint32_t dma_desc_num;
+    uint32_t dma_frame_num;
+
+    // Streaming: frames are encoded stream_leds LEDs at a time into
+    // out_buffers[0] and written chunk by chunk, so no buffer holds a frame
+    uint16_t stream_leds;       // LEDs per chunk, 0 = whole-frame buffers
+    uint32_t stream_encode_us;  // Longest chunk encode of the last frame
+    uint32_t stream_slack_us;   // Encode time the DMA ring covers
+    uint32_t stream_underruns;  // Chunks since init that took longer
+
+#if NEOLED_ASYNC
+    SemaphoreHandle_t buffer_free[NEOLED_BUFFER_COUNT];
+    QueueHandle_t frame_queue;
+    SemaphoreHandle_t writer_exit;
+    neoled_update_cb_t update_callback;
+    void* update_callback_arg;
+#endif
+
+#if NEOLED_RENDER
+    // Render task: a lock-free triple buffer of pixel slots. The producer
+    // draws into render_back, the task sends render_front, and the newest
+    // submitted slot waits in between until the task takes it
+    uint8_t* render_slots[3];            // One pixel frame each, NULL while stopped
+    uint8_t render_back;                 // Producer's slot
+    uint8_t render_front;                // Render task's slot
+    std::atomic<uint8_t> render_middle;  // Slot index, RENDER_FRESH until taken
+    std::atomic<bool> render_stop;
+    std::atomic<uint32_t> render_dropped;  // Frames replaced before the task took them
+    std::atomic<bool> render_running;
+    SemaphoreHandle_t render_wake;
+    SemaphoreHandle_t render_exit;
+#endif
+};
+
 // ============================================================================
-// I2S Configuration (Version-specific)
+// I2S Backend (Version-specific)
 // ============================================================================
 
+/**
+ * @brief I2S backend state, one per initialized strip
+ */
+typedef struct {
+    int port;
+    int gpio_pin;
+    uint32_t sample_rate;
+    TickType_t idle_tick;   // Tick by which the last write has left the DMA buffers
 #if NEOLED_USE_NEW_I2S_DRIVER
-    // ESP-IDF 5.x: New I2S driver handle
-    static i2s_chan_handle_t tx_handle = NULL;
-#else
-    // ESP-IDF 4.x: Legacy I2S configuration
-    static i2s_config_t i2s_config = {
+    i2s_chan_handle_t tx_handle;
+#endif
+} I2SBackend;
+
+// Ports claimed by an I2S backend instance. Strips may be initialised from
+// several tasks at once, so a port is checked and claimed in one step under
+// i2s_ports_lock.
+static bool i2s_ports_used[SOC_I2S_NUM] = {};
+static portMUX_TYPE i2s_ports_lock = portMUX_INITIALIZER_UNLOCKED;
+
+#if !NEOLED_USE_NEW_I2S_DRIVER
+    // ESP-IDF 4.x: Legacy I2S configuration, copied per strip at init
+    static const i2s_config_t i2s_config_base = {
         .mode = static_cast<i2s_mode_t>(I2S_MODE_MASTER | I2S_MODE_TX),
         .sample_rate = SAMPLE_RATE,
         .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
@@ -79,8 +374,8 @@ static const uint16_t bitpatterns[4] = {0x88, 0x8e, 0xe8, 0xee};
         .communication_format = static_cast<i2s_comm_format_t>(I2S_COMM_FORMAT_I2S | I2S_COMM_FORMAT_I2S_MSB),
     #endif
         .intr_alloc_flags = 0,
-        .dma_buf_count = 4,
-        .dma_buf_len = LED_NUMBER * PIXEL_SIZE,
+        .dma_buf_count = 2,   // Set from the backend config at init
+        .dma_buf_len = 8,
         .use_apll = false,
     #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 4, 0)
         .mclk_multiple = I2S_MCLK_MULTIPLE_DEFAULT,
@@ -88,7 +383,7 @@ static const uint16_t bitpatterns[4] = {0x88, 0x8e, 0xe8, 0xee};
         .tx_desc_auto_clear = true
     };
 
-    static i2s_pin_config_t pin_config = {
+    static const i2s_pin_config_t pin_config_base = {
     #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 4, 0)
         .mck_io_num = I2S_PIN_NO_CHANGE,
     #endif
@@ -99,81 +394,131 @@ static const uint16_t bitpatterns[4] = {0x88, 0x8e, 0xe8, 0xee};
     };
 #endif
 
-// ============================================================================
-// Internal Helper Functions
-// ============================================================================
+/**
+ * @brief Give up a port claimed by i2sCreate()
+ * @param port I2S port the caller claimed
+ */
+static void i2sUnclaim(int port)
+{
+    taskENTER_CRITICAL(&i2s_ports_lock);
+    i2s_ports_used[port] = false;
+    taskEXIT_CRITICAL(&i2s_ports_lock);
+}
 
 /**
- * @brief Convert pixel data to I2S bit patterns
- * @param pixel Source pixel
- * @param buffer Output buffer (must be at least PIXEL_SIZE bytes)
- * @param brightness Brightness multiplier (0-255)
+ * @brief Claim an I2S port and allocate the backend state
+ * @param config Backend configuration
+ * @return Backend state, or NULL with the error in *err
  */
-static void pixelToBitPattern(const Pixel& pixel, uint8_t* buffer, uint8_t brightness)
+static I2SBackend* i2sCreate(const neoled_backend_config_t* config, neoled_err_t* err)
 {
-    // Apply brightness
-    uint8_t r = (uint8_t)((pixel.red * brightness) / 255);
-    uint8_t g = (uint8_t)((pixel.green * brightness) / 255);
-    uint8_t b = (uint8_t)((pixel.blue * brightness) / 255);
+    if (config->port < 0 || config->port >= SOC_I2S_NUM) {
+        ESP_LOGE(TAG, "Invalid I2S port %d", config->port);
+        *err = NEOLED_ERR_PARAM;
+        return NULL;
+    }
 
-    // Green first (WS2812 uses GRB format)
-    buffer[0] = bitpatterns[g >> 6 & 0x03];
-    buffer[1] = bitpatterns[g >> 4 & 0x03];
-    buffer[2] = bitpatterns[g >> 2 & 0x03];
-    buffer[3] = bitpatterns[g & 0x03];
+    taskENTER_CRITICAL(&i2s_ports_lock);
+    bool claimed = !i2s_ports_used[config->port];
+    i2s_ports_used[config->port] = true;
+    taskEXIT_CRITICAL(&i2s_ports_lock);
+    if (!claimed) {
+        ESP_LOGE(TAG, "I2S%d already in use by another strip", config->port);
+        *err = NEOLED_ERR_INIT;
+        return NULL;
+    }
 
-    // Red
-    buffer[4] = bitpatterns[r >> 6 & 0x03];
-    buffer[5] = bitpatterns[r >> 4 & 0x03];
-    buffer[6] = bitpatterns[r >> 2 & 0x03];
-    buffer[7] = bitpatterns[r & 0x03];
+    I2SBackend* b = new (std::nothrow) I2SBackend();
+    if (b == NULL) {
+        i2sUnclaim(config->port);
+        *err = NEOLED_ERR_NO_MEM;
+        return NULL;
+    }
 
-    // Blue
-    buffer[8] = bitpatterns[b >> 6 & 0x03];
-    buffer[9] = bitpatterns[b >> 4 & 0x03];
-    buffer[10] = bitpatterns[b >> 2 & 0x03];
-    buffer[11] = bitpatterns[b & 0x03];
+    b->port = config->port;
+    b->gpio_pin = config->gpio_pin;
+    b->sample_rate = config->sample_rate;
+    b->idle_tick = xTaskGetTickCount();
+    return b;
 }
 
-// ============================================================================
-// Core Functions Implementation
-// ============================================================================
+/**
+ * @brief Release the port, reset the data GPIO and free the backend state
+ * @param b Backend state, which exists only for a port its strip claimed
+ */
+static void i2sRelease(I2SBackend* b)
+{
+    gpio_reset_pin(static_cast<gpio_num_t>(b->gpio_pin));
+    i2sUnclaim(b->port);
+    delete b;
+}
 
-neoled_err_t init(void)
+/**
+ * @brief Note when a just-queued write will have left the DMA buffers
+ * @param b Backend state
+ * @param length Bytes written
+ */
+static void i2sTrackWrite(I2SBackend* b, size_t length)
 {
-    return initWithPin(I2S_DO_IO);
+    // The write returns once the data is in the DMA buffers, which hold at
+    // most one frame, so it is on the wire within its own wire time
+    uint64_t wire_us = (uint64_t)length * 1000000ULL / ((uint64_t)b->sample_rate * I2S_SAMPLE_BYTES);
+    b->idle_tick = xTaskGetTickCount() + pdMS_TO_TICKS((uint32_t)(wire_us / 1000) + 1) + 1;
 }
 
-neoled_err_t initWithPin(int gpio_pin)
+/**
+ * @brief Wait until the last write has left the DMA buffers
+ */
+static neoled_err_t i2sFlush(void* handle, uint32_t timeout_ms)
 {
-    if (initialized) {
-        ESP_LOGW(TAG, "Already initialized, call destroy() first");
-        return NEOLED_OK;  // Already initialized is not an error
+    I2SBackend* b = static_cast<I2SBackend*>(handle);
+
+    TickType_t remaining = b->idle_tick - xTaskGetTickCount();
+    if ((int32_t)remaining <= 0) {
+        return NEOLED_OK;
+    }
+
+    if (timeout_ms != UINT32_MAX && remaining > pdMS_TO_TICKS(timeout_ms)) {
+        vTaskDelay(pdMS_TO_TICKS(timeout_ms));
+        return NEOLED_ERR_TIMEOUT;
     }
 
-    size_buffer = LED_NUMBER * PIXEL_SIZE;
-    current_gpio_pin = gpio_pin;
-    esp_err_t ret;
+    vTaskDelay(remaining);
+    return NEOLED_OK;
+}
 
 #if NEOLED_USE_NEW_I2S_DRIVER
-    // ESP-IDF 5.x: New I2S driver initialization
+// ESP-IDF 5.x: New I2S driver (i2s_std)
+
+/**
+ * @brief Create, configure and enable an I2S TX channel
+ */
+static neoled_err_t i2sStdInit(const neoled_backend_config_t* config, void** handle)
+{
+    neoled_err_t err = NEOLED_OK;
+    I2SBackend* b = i2sCreate(config, &err);
+    if (b == NULL) {
+        return err;
+    }
+
     i2s_chan_config_t chan_cfg = {
-        .id = (i2s_port_t)I2S_NUM,
+        .id = (i2s_port_t)config->port,
         .role = I2S_ROLE_MASTER,
-        .dma_desc_num = 4,
-        .dma_frame_num = LED_NUMBER * PIXEL_SIZE,
+        .dma_desc_num = config->dma_desc_num,
+        .dma_frame_num = config->dma_frame_num,
         .auto_clear = true
     };
 
-    ret = i2s_new_channel(&chan_cfg, &tx_handle, NULL);
+    esp_err_t ret = i2s_new_channel(&chan_cfg, &b->tx_handle, NULL);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to create I2S channel: %s", esp_err_to_name(ret));
+        i2sRelease(b);
         return NEOLED_ERR_I2S;
     }
 
     i2s_std_config_t std_cfg = {
         .clk_cfg = {
-            .sample_rate_hz = SAMPLE_RATE,
+            .sample_rate_hz = config->sample_rate,
             .clk_src = I2S_CLK_SRC_DEFAULT,
             .mclk_multiple = I2S_MCLK_MULTIPLE_DEFAULT
         },
@@ -193,7 +538,7 @@ neoled_err_t initWithPin(int gpio_pin)
             .mclk = I2S_GPIO_UNUSED,
             .bclk = I2S_GPIO_UNUSED,
             .ws = I2S_GPIO_UNUSED,
-            .dout = (gpio_num_t)gpio_pin,
+            .dout = (gpio_num_t)config->gpio_pin,
             .din = I2S_GPIO_UNUSED,
             .invert_flags = {
                 .mclk_inv = false,
@@ -203,226 +548,4961 @@ neoled_err_t initWithPin(int gpio_pin)
         }
     };
 
-    ret = i2s_channel_init_std_mode(tx_handle, &std_cfg);
+    ret = i2s_channel_init_std_mode(b->tx_handle, &std_cfg);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to init I2S channel: %s", esp_err_to_name(ret));
-        i2s_del_channel(tx_handle);
-        tx_handle = NULL;
+        i2s_del_channel(b->tx_handle);
+        i2sRelease(b);
         return NEOLED_ERR_I2S;
     }
 
-    ret = i2s_channel_enable(tx_handle);
+    ret = i2s_channel_enable(b->tx_handle);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to enable I2S channel: %s", esp_err_to_name(ret));
-        i2s_del_channel(tx_handle);
-        tx_handle = NULL;
+        i2s_del_channel(b->tx_handle);
+        i2sRelease(b);
         return NEOLED_ERR_I2S;
     }
 
-#else
-    // ESP-IDF 4.x: Legacy I2S driver initialization
-    pin_config.data_out_num = gpio_pin;
+    *handle = b;
+    return NEOLED_OK;
+}
 
-    ret = i2s_driver_install(static_cast<i2s_port_t>(I2S_NUM), &i2s_config, 0, nullptr);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to install I2S driver: %s", esp_err_to_name(ret));
-        return NEOLED_ERR_I2S;
-    }
+/**
+ * @brief Copy a frame into the DMA buffers (blocks while they are full)
+ */
+static neoled_err_t i2sStdWrite(void* handle, const uint8_t* data, size_t length)
+{
+    I2SBackend* b = static_cast<I2SBackend*>(handle);
+    size_t bytes_written = 0;
 
-    ret = i2s_set_pin(static_cast<i2s_port_t>(I2S_NUM), &pin_config);
+    esp_err_t ret = i2s_channel_write(b->tx_handle, data, length, &bytes_written, portMAX_DELAY);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set I2S pins: %s", esp_err_to_name(ret));
-        i2s_driver_uninstall(static_cast<i2s_port_t>(I2S_NUM));
+        ESP_LOGE(TAG, "I2S write failed: %s", esp_err_to_name(ret));
         return NEOLED_ERR_I2S;
     }
-#endif
 
-    initialized = true;
-    ESP_LOGI(TAG, "Initialized with GPIO %d, %d LEDs", gpio_pin, LED_NUMBER);
-    
-    // Clear LEDs on init
-    clear();
-    
+    i2sTrackWrite(b, length);
     return NEOLED_OK;
 }
 
-neoled_err_t update(const Pixel* pixels)
+/**
+ * @brief Disable and delete the TX channel
+ */
+static void i2sStdDeinit(void* handle)
 {
-    return updateWithBrightness(pixels, global_brightness);
-}
+    I2SBackend* b = static_cast<I2SBackend*>(handle);
 
-neoled_err_t updateWithBrightness(const Pixel* pixels, uint8_t brightness)
-{
-    if (!initialized) {
-        ESP_LOGE(TAG, "Not initialized");
-        return NEOLED_ERR_NOT_INIT;
+    esp_err_t ret = i2s_channel_disable(b->tx_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to disable I2S channel: %s", esp_err_to_name(ret));
     }
 
-    if (pixels == nullptr) {
-        ESP_LOGE(TAG, "Null pixel pointer");
-        return NEOLED_ERR_PARAM;
+    ret = i2s_del_channel(b->tx_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to delete I2S channel: %s", esp_err_to_name(ret));
     }
 
-    // Convert all pixels to bit patterns
-    for (uint16_t i = 0; i < LED_NUMBER; i++) {
-        int loc = i * PIXEL_SIZE;
-        pixelToBitPattern(pixels[i], &out_buffer[loc], brightness);
+    i2sRelease(b);
+}
+
+static const neoled_backend_t i2s_backend = {
+    "i2s_std", NEOLED_FRAME_I2S, i2sStdInit, i2sStdWrite, i2sFlush, i2sStdDeinit
+};
+
+#else
+// ESP-IDF 4.x: Legacy I2S driver
+
+/**
+ * @brief Install the legacy I2S driver on the port
+ */
+static neoled_err_t i2sLegacyInit(const neoled_backend_config_t* config, void** handle)
+{
+    neoled_err_t err = NEOLED_OK;
+    I2SBackend* b = i2sCreate(config, &err);
+    if (b == NULL) {
+        return err;
     }
 
-    size_t bytes_written = 0;
-    esp_err_t ret;
+    i2s_config_t i2s_config = i2s_config_base;
+    i2s_config.sample_rate = config->sample_rate;
+    i2s_config.dma_buf_count = (int)config->dma_desc_num;
+    i2s_config.dma_buf_len = (int)config->dma_frame_num;
 
-#if NEOLED_USE_NEW_I2S_DRIVER
-    // ESP-IDF 5.x: New I2S write
-    ret = i2s_channel_write(tx_handle, out_buffer, size_buffer, &bytes_written, portMAX_DELAY);
+    i2s_pin_config_t pin_config = pin_config_base;
+    pin_config.data_out_num = config->gpio_pin;
+
+    esp_err_t ret = i2s_driver_install(static_cast<i2s_port_t>(b->port), &i2s_config, 0, nullptr);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "I2S write failed: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Failed to install I2S driver: %s", esp_err_to_name(ret));
+        i2sRelease(b);
         return NEOLED_ERR_I2S;
     }
 
-    ret = i2s_channel_write(tx_handle, off_buffer, ZERO_BUFFER, &bytes_written, portMAX_DELAY);
+    ret = i2s_set_pin(static_cast<i2s_port_t>(b->port), &pin_config);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "I2S write (reset) failed: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Failed to set I2S pins: %s", esp_err_to_name(ret));
+        i2s_driver_uninstall(static_cast<i2s_port_t>(b->port));
+        i2sRelease(b);
         return NEOLED_ERR_I2S;
     }
-#else
-    // ESP-IDF 4.x: Legacy I2S write
-    ret = i2s_write(static_cast<i2s_port_t>(I2S_NUM), out_buffer, size_buffer, &bytes_written, portMAX_DELAY);
+
+    *handle = b;
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Copy a frame into the DMA buffers (blocks while they are full)
+ */
+static neoled_err_t i2sLegacyWrite(void* handle, const uint8_t* data, size_t length)
+{
+    I2SBackend* b = static_cast<I2SBackend*>(handle);
+    size_t bytes_written = 0;
+
+    esp_err_t ret = i2s_write(static_cast<i2s_port_t>(b->port), data, length, &bytes_written, portMAX_DELAY);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "I2S write failed: %s", esp_err_to_name(ret));
         return NEOLED_ERR_I2S;
     }
 
-    ret = i2s_write(static_cast<i2s_port_t>(I2S_NUM), off_buffer, ZERO_BUFFER, &bytes_written, portMAX_DELAY);
+    i2sTrackWrite(b, length);
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Uninstall the legacy I2S driver
+ */
+static void i2sLegacyDeinit(void* handle)
+{
+    I2SBackend* b = static_cast<I2SBackend*>(handle);
+
+    esp_err_t ret = i2s_driver_uninstall(static_cast<i2s_port_t>(b->port));
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "I2S write (reset) failed: %s", esp_err_to_name(ret));
-        return NEOLED_ERR_I2S;
+        ESP_LOGW(TAG, "Failed to uninstall I2S driver: %s", esp_err_to_name(ret));
     }
-#endif
 
-    // Small delay for data latch
-    vTaskDelay(pdMS_TO_TICKS(1));
+    i2sRelease(b);
+}
 
-#if NEOLED_USE_NEW_I2S_DRIVER
-    // Clear DMA buffer in new driver if needed
-#else
-    i2s_zero_dma_buffer(static_cast<i2s_port_t>(I2S_NUM));
+static const neoled_backend_t i2s_backend = {
+    "i2s_legacy", NEOLED_FRAME_I2S, i2sLegacyInit, i2sLegacyWrite, i2sFlush, i2sLegacyDeinit
+};
 #endif
 
-    return NEOLED_OK;
+const neoled_backend_t* i2sBackend(void)
+{
+    return &i2s_backend;
 }
 
-neoled_err_t clear(void)
-{
-    if (!initialized) {
-        return NEOLED_ERR_NOT_INIT;
-    }
+#if NEOLED_RMT
+// ============================================================================
+// RMT Backend (Version-specific)
+// ============================================================================
+
+/**
+ * @brief Protocol bit timing in RMT ticks
+ */
+typedef struct {
+    uint16_t t0h;
+    uint16_t t0l;
+    uint16_t t1h;
+    uint16_t t1l;
+    uint16_t reset_half;    // Reset is one symbol of two low halves
+} RmtTiming;
 
-    // Create array of off pixels
-    Pixel off_pixels[LED_NUMBER];
-    memset(off_pixels, 0, sizeof(off_pixels));
-    
-    return updateWithBrightness(off_pixels, 0);
+static uint16_t rmtTicks(uint64_t ns)
+{
+    return (uint16_t)((ns * NEOLED_RMT_RESOLUTION_HZ + 500000000ULL) / 1000000000ULL);
 }
 
-neoled_err_t destroy(void)
+/**
+ * @brief Convert the strip protocol's timing to RMT ticks
+ */
+static RmtTiming rmtTiming(const neoled_backend_config_t* config)
 {
-    if (!initialized) {
-        return NEOLED_OK;  // Not an error to destroy when not initialized
-    }
+    // Low times fill out the rounded bit period so rounding never stretches it
+    uint16_t bit = rmtTicks(config->bit_ns);
+    RmtTiming timing;
+    timing.t0h = rmtTicks(config->t0h_ns);
+    timing.t0l = bit - timing.t0h;
+    timing.t1h = rmtTicks(config->t1h_ns);
+    timing.t1l = bit - timing.t1h;
+    timing.reset_half = rmtTicks(config->reset_us * 500ULL);
+    return timing;
+}
 
-    // Turn off LEDs before destroying
-    clear();
+#if NEOLED_USE_NEW_I2S_DRIVER
+// ESP-IDF 5.x: RMT TX channel with a streaming encoder
 
-    esp_err_t ret;
+/**
+ * @brief Frame encoder: colour bytes through the bytes encoder, then the reset
+ * @note The RMT driver calls encode() from its ISR whenever channel memory
+ *       frees up, so symbols are produced on the fly and never held for a
+ *       whole frame
+ */
+typedef struct {
+    rmt_encoder_t base;             // Must stay first, the driver passes &base
+    rmt_encoder_t* bytes_encoder;   // Colour bits to T0/T1 symbols, MSB first
+    rmt_encoder_t* copy_encoder;    // Copies the reset symbol
+    int state;                      // 0 = sending LED data, 1 = sending reset
+    rmt_symbol_word_t reset_symbol;
+} RmtFrameEncoder;
 
-#if NEOLED_USE_NEW_I2S_DRIVER
-    // ESP-IDF 5.x: Cleanup new I2S driver
-    if (tx_handle != NULL) {
-        ret = i2s_channel_disable(tx_handle);
-        if (ret != ESP_OK) {
-            ESP_LOGW(TAG, "Failed to disable I2S channel: %s", esp_err_to_name(ret));
-        }
+/**
+ * @brief RMT backend state, one per initialized strip
+ */
+typedef struct {
+    rmt_channel_handle_t channel;
+    rmt_encoder_t* encoder;
+    int gpio_pin;
+} RmtBackend;
 
-        ret = i2s_del_channel(tx_handle);
-        if (ret != ESP_OK) {
-            ESP_LOGW(TAG, "Failed to delete I2S channel: %s", esp_err_to_name(ret));
+/**
+ * @brief Encode as much of the frame as fits in the free channel memory
+ */
+static size_t IRAM_ATTR rmtEncodeFrame(rmt_encoder_t* encoder, rmt_channel_handle_t channel,
+                                       const void* data, size_t data_size, rmt_encode_state_t* ret_state)
+{
+    RmtFrameEncoder* e = reinterpret_cast<RmtFrameEncoder*>(encoder);
+    rmt_encode_state_t session_state = RMT_ENCODING_RESET;
+    int state = RMT_ENCODING_RESET;
+    size_t encoded = 0;
+
+    if (e->state == 0) {
+        encoded += e->bytes_encoder->encode(e->bytes_encoder, channel, data, data_size, &session_state);
+        if (session_state & RMT_ENCODING_COMPLETE) {
+            e->state = 1;
+        }
+        if (session_state & RMT_ENCODING_MEM_FULL) {
+            *ret_state = (rmt_encode_state_t)(state | RMT_ENCODING_MEM_FULL);
+            return encoded;
         }
-        tx_handle = NULL;
-    }
-#else
-    // ESP-IDF 4.x: Cleanup legacy I2S driver
-    ret = i2s_driver_uninstall(static_cast<i2s_port_t>(I2S_NUM));
-    if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to uninstall I2S driver: %s", esp_err_to_name(ret));
     }
-#endif
 
-    // Reset GPIO pin
-    gpio_reset_pin(static_cast<gpio_num_t>(current_gpio_pin));
-
-    initialized = false;
-    ESP_LOGI(TAG, "Destroyed");
+    if (e->state == 1) {
+        encoded += e->copy_encoder->encode(e->copy_encoder, channel, &e->reset_symbol,
+                                           sizeof(e->reset_symbol), &session_state);
+        if (session_state & RMT_ENCODING_COMPLETE) {
+            e->state = 0;
+            state |= RMT_ENCODING_COMPLETE;
+        }
+        if (session_state & RMT_ENCODING_MEM_FULL) {
+            state |= RMT_ENCODING_MEM_FULL;
+        }
+    }
 
-    return NEOLED_OK;
+    *ret_state = (rmt_encode_state_t)state;
+    return encoded;
 }
 
-bool isInitialized(void)
+/**
+ * @brief Restart the frame encoder after a completed or aborted frame
+ */
+static esp_err_t rmtResetFrameEncoder(rmt_encoder_t* encoder)
 {
-    return initialized;
+    RmtFrameEncoder* e = reinterpret_cast<RmtFrameEncoder*>(encoder);
+    rmt_encoder_reset(e->bytes_encoder);
+    rmt_encoder_reset(e->copy_encoder);
+    e->state = 0;
+    return ESP_OK;
 }
 
-void setBrightness(uint8_t brightness)
+/**
+ * @brief Delete the frame encoder and its sub-encoders
+ */
+static esp_err_t rmtDeleteFrameEncoder(rmt_encoder_t* encoder)
 {
-    global_brightness = brightness;
+    RmtFrameEncoder* e = reinterpret_cast<RmtFrameEncoder*>(encoder);
+    if (e->bytes_encoder != NULL) {
+        rmt_del_encoder(e->bytes_encoder);
+    }
+    if (e->copy_encoder != NULL) {
+        rmt_del_encoder(e->copy_encoder);
+    }
+    delete e;
+    return ESP_OK;
 }
 
-uint8_t getBrightness(void)
+/**
+ * @brief Create the frame encoder for one protocol's timing
+ * @return Encoder, or NULL if a sub-encoder could not be created
+ */
+static rmt_encoder_t* rmtCreateFrameEncoder(const RmtTiming* timing)
 {
-    return global_brightness;
-}
+    RmtFrameEncoder* e = new (std::nothrow) RmtFrameEncoder();
+    if (e == NULL) {
+        return NULL;
+    }
 
-// ============================================================================
-// Gamma Correction
-// ============================================================================
+    e->base.encode = rmtEncodeFrame;
+    e->base.reset = rmtResetFrameEncoder;
+    e->base.del = rmtDeleteFrameEncoder;
 
-// Gamma correction lookup table (gamma = 2.2)
-static const uint8_t gamma22_table[256] = {
-    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
-    2,   3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   5,   5,   5,
-    5,   6,   6,   6,   6,   7,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,
-   10,  10,  11,  11,  11,  12,  12,  13,  13,  13,  14,  14,  15,  15,  16,  16,
-   17,  17,  18,  18,  19,  19,  20,  20,  21,  21,  22,  22,  23,  24,  24,  25,
-   25,  26,  27,  27,  28,  29,  29,  30,  31,  32,  32,  33,  34,  35,  35,  36,
-   37,  38,  39,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  50,
-   51,  52,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  66,  67,  68,
-   69,  70,  72,  73,  74,  75,  77,  78,  79,  81,  82,  83,  85,  86,  87,  89,
-   90,  92,  93,  95,  96,  98,  99, 101, 102, 104, 105, 107, 109, 110, 112, 114,
-  115, 117, 119, 120, 122, 124, 126, 127, 129, 131, 133, 135, 137, 138, 140, 142,
-  144, 146, 148, 150, 152, 154, 156, 158, 160, 162, 164, 167, 169, 171, 173, 175,
-  177, 180, 182, 184, 186, 189, 191, 193, 196, 198, 200, 203, 205, 208, 210, 213,
-  215, 218, 220, 223, 225, 228, 231, 233, 236, 239, 241, 244, 247, 249, 252, 255
+    rmt_bytes_encoder_config_t bytes_config = {};
+    bytes_config.bit0.level0 = 1;
+    bytes_config.bit0.duration0 = timing->t0h;
+    bytes_config.bit0.level1 = 0;
+    bytes_config.bit0.duration1 = timing->t0l;
+    bytes_config.bit1.level0 = 1;
+    bytes_config.bit1.duration0 = timing->t1h;
+    bytes_config.bit1.level1 = 0;
+    bytes_config.bit1.duration1 = timing->t1l;
+    bytes_config.flags.msb_first = 1;
+
+    rmt_copy_encoder_config_t copy_config = {};
+
+    if (rmt_new_bytes_encoder(&bytes_config, &e->bytes_encoder) != ESP_OK ||
+        rmt_new_copy_encoder(&copy_config, &e->copy_encoder) != ESP_OK) {
+        rmtDeleteFrameEncoder(&e->base);
+        return NULL;
+    }
+
+    e->reset_symbol.level0 = 0;
+    e->reset_symbol.duration0 = timing->reset_half;
+    e->reset_symbol.level1 = 0;
+    e->reset_symbol.duration1 = timing->reset_half;
+    return &e->base;
+}
+
+/**
+ * @brief Create and enable an RMT TX channel (the port is unused, channels
+ *        are allocated by the driver)
+ */
+static neoled_err_t rmtInit(const neoled_backend_config_t* config, void** handle)
+{
+    RmtBackend* b = new (std::nothrow) RmtBackend();
+    if (b == NULL) {
+        return NEOLED_ERR_NO_MEM;
+    }
+    b->gpio_pin = config->gpio_pin;
+
+    rmt_tx_channel_config_t channel_config = {};
+    channel_config.gpio_num = (gpio_num_t)config->gpio_pin;
+    channel_config.clk_src = RMT_CLK_SRC_DEFAULT;
+    channel_config.resolution_hz = NEOLED_RMT_RESOLUTION_HZ;
+    channel_config.mem_block_symbols = NEOLED_RMT_MEM_SYMBOLS;
+    channel_config.trans_queue_depth = 1;
+
+    esp_err_t ret = rmt_new_tx_channel(&channel_config, &b->channel);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create RMT channel: %s", esp_err_to_name(ret));
+        delete b;
+        return NEOLED_ERR_INIT;
+    }
+
+    RmtTiming timing = rmtTiming(config);
+    b->encoder = rmtCreateFrameEncoder(&timing);
+    if (b->encoder == NULL) {
+        ESP_LOGE(TAG, "Failed to create RMT encoder");
+        rmt_del_channel(b->channel);
+        delete b;
+        return NEOLED_ERR_NO_MEM;
+    }
+
+    ret = rmt_enable(b->channel);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to enable RMT channel: %s", esp_err_to_name(ret));
+        rmt_del_encoder(b->encoder);
+        rmt_del_channel(b->channel);
+        delete b;
+        return NEOLED_ERR_INIT;
+    }
+
+    *handle = b;
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Send one frame of colour bytes and its reset
+ * @note Waits for the transmission, as the encoder reads the frame in place
+ */
+static neoled_err_t rmtWrite(void* handle, const uint8_t* data, size_t length)
+{
+    RmtBackend* b = static_cast<RmtBackend*>(handle);
+
+    rmt_transmit_config_t tx_config = {};
+    esp_err_t ret = rmt_transmit(b->channel, b->encoder, data, length, &tx_config);
+    if (ret == ESP_OK) {
+        ret = rmt_tx_wait_all_done(b->channel, -1);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "RMT transmit failed: %s", esp_err_to_name(ret));
+        return NEOLED_ERR_I2S;
+    }
+
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Wait for the channel to go idle
+ */
+static neoled_err_t rmtFlush(void* handle, uint32_t timeout_ms)
+{
+    RmtBackend* b = static_cast<RmtBackend*>(handle);
+    int timeout = (timeout_ms == UINT32_MAX) ? -1 : (int)timeout_ms;
+    return rmt_tx_wait_all_done(b->channel, timeout) == ESP_OK ? NEOLED_OK : NEOLED_ERR_TIMEOUT;
+}
+
+/**
+ * @brief Disable and delete the channel and encoder
+ */
+static void rmtDeinit(void* handle)
+{
+    RmtBackend* b = static_cast<RmtBackend*>(handle);
+
+    rmt_disable(b->channel);
+    rmt_del_encoder(b->encoder);
+    rmt_del_channel(b->channel);
+    gpio_reset_pin(static_cast<gpio_num_t>(b->gpio_pin));
+    delete b;
+}
+
+#else
+// ESP-IDF 4.x: Legacy RMT driver with a sample translator
+
+/**
+ * @brief RMT backend state, one per initialized strip
+ */
+typedef struct {
+    rmt_channel_t channel;
+    int gpio_pin;
+    rmt_item32_t bit0;      // Translator items for the strip's protocol
+    rmt_item32_t bit1;
+    rmt_item32_t reset;
+} RmtBackend;
+
+/**
+ * @brief Translate colour bytes into RMT items as the driver needs them
+ * @note Called from the RMT ISR each time half of the channel memory frees up
+ */
+static void IRAM_ATTR rmtTranslate(const void* src, rmt_item32_t* dest, size_t src_size,
+                                   size_t wanted_num, size_t* translated_size, size_t* item_num)
+{
+    void* context = NULL;
+    rmt_translator_get_context(item_num, &context);
+    const RmtBackend* b = static_cast<const RmtBackend*>(context);
+    const uint32_t bit0 = b->bit0.val;
+    const uint32_t bit1 = b->bit1.val;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(src);
+    size_t size = 0;
+    size_t num = 0;
+    while (size < src_size && num + 8 <= wanted_num) {
+        for (int bit = 7; bit >= 0; bit--) {
+            dest[num++].val = (bytes[size] >> bit & 0x01) ? bit1 : bit0;
+        }
+        size++;
+    }
+
+    *translated_size = size;
+    *item_num = num;
+}
+
+/**
+ * @brief Install the legacy RMT driver on the channel given as the port
+ */
+static neoled_err_t rmtInit(const neoled_backend_config_t* config, void** handle)
+{
+    if (config->port < 0 || config->port >= RMT_CHANNEL_MAX) {
+        ESP_LOGE(TAG, "Invalid RMT channel %d", config->port);
+        return NEOLED_ERR_PARAM;
+    }
+
+    RmtBackend* b = new (std::nothrow) RmtBackend();
+    if (b == NULL) {
+        return NEOLED_ERR_NO_MEM;
+    }
+    b->channel = (rmt_channel_t)config->port;
+    b->gpio_pin = config->gpio_pin;
+
+    RmtTiming timing = rmtTiming(config);
+    b->bit0.level0 = 1;
+    b->bit0.duration0 = timing.t0h;
+    b->bit0.level1 = 0;
+    b->bit0.duration1 = timing.t0l;
+    b->bit1.level0 = 1;
+    b->bit1.duration0 = timing.t1h;
+    b->bit1.level1 = 0;
+    b->bit1.duration1 = timing.t1l;
+    b->reset.duration0 = timing.reset_half;
+    b->reset.duration1 = timing.reset_half;
+
+    rmt_config_t rmt_cfg = RMT_DEFAULT_CONFIG_TX((gpio_num_t)config->gpio_pin, b->channel);
+    rmt_cfg.clk_div = (uint8_t)(80000000 / NEOLED_RMT_RESOLUTION_HZ);
+    rmt_cfg.mem_block_num = (NEOLED_RMT_MEM_SYMBOLS + 63) / 64;
+
+    esp_err_t ret = rmt_config(&rmt_cfg);
+    if (ret == ESP_OK) {
+        ret = rmt_driver_install(b->channel, 0, 0);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to install RMT driver: %s", esp_err_to_name(ret));
+        delete b;
+        return NEOLED_ERR_INIT;
+    }
+
+    ret = rmt_translator_init(b->channel, rmtTranslate);
+    if (ret == ESP_OK) {
+        ret = rmt_translator_set_context(b->channel, b);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to init RMT translator: %s", esp_err_to_name(ret));
+        rmt_driver_uninstall(b->channel);
+        delete b;
+        return NEOLED_ERR_INIT;
+    }
+
+    *handle = b;
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Send one frame of colour bytes followed by a reset item
+ */
+static neoled_err_t rmtWrite(void* handle, const uint8_t* data, size_t length)
+{
+    RmtBackend* b = static_cast<RmtBackend*>(handle);
+
+    esp_err_t ret = rmt_write_sample(b->channel, data, length, true);
+    if (ret == ESP_OK) {
+        ret = rmt_write_items(b->channel, &b->reset, 1, true);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "RMT write failed: %s", esp_err_to_name(ret));
+        return NEOLED_ERR_I2S;
+    }
+
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Wait for the channel to go idle
+ */
+static neoled_err_t rmtFlush(void* handle, uint32_t timeout_ms)
+{
+    RmtBackend* b = static_cast<RmtBackend*>(handle);
+    TickType_t timeout = (timeout_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return rmt_wait_tx_done(b->channel, timeout) == ESP_OK ? NEOLED_OK : NEOLED_ERR_TIMEOUT;
+}
+
+/**
+ * @brief Uninstall the legacy RMT driver
+ */
+static void rmtDeinit(void* handle)
+{
+    RmtBackend* b = static_cast<RmtBackend*>(handle);
+
+    rmt_driver_uninstall(b->channel);
+    gpio_reset_pin(static_cast<gpio_num_t>(b->gpio_pin));
+    delete b;
+}
+#endif
+
+static const neoled_backend_t rmt_backend = {
+    "rmt", NEOLED_FRAME_GRB, rmtInit, rmtWrite, rmtFlush, rmtDeinit
+};
+
+const neoled_backend_t* rmtBackend(void)
+{
+    return &rmt_backend;
+}
+#endif
+
+#if NEOLED_SPI
+// ============================================================================
+// SPI Backend
+// ============================================================================
+
+/**
+ * @brief SPI backend state, one per initialized strip
+ * @note Each queued frame is copied into its own DMA buffer, so up to
+ *       NEOLED_SPI_QUEUE_DEPTH frames are in flight while the strip encodes
+ *       the next one
+ */
+typedef struct {
+    spi_host_device_t host;
+    spi_device_handle_t device;
+    int gpio_pin;
+    size_t buffer_bytes;
+    uint8_t* buffers[NEOLED_SPI_QUEUE_DEPTH];
+    spi_transaction_t transactions[NEOLED_SPI_QUEUE_DEPTH];
+    int next;       // Slot for the next frame
+    int in_flight;  // Queued transactions not yet reclaimed
+} SpiBackend;
+
+/**
+ * @brief Reclaim the oldest queued transaction
+ * @return true if one finished within the timeout
+ */
+static bool spiReclaim(SpiBackend* b, TickType_t timeout)
+{
+    spi_transaction_t* done;
+    if (spi_device_get_trans_result(b->device, &done, timeout) != ESP_OK) {
+        return false;
+    }
+    b->in_flight--;
+    return true;
+}
+
+/**
+ * @brief Release everything spiInit() set up
+ */
+static void spiRelease(SpiBackend* b, bool bus_ready)
+{
+    if (b->device != NULL) {
+        spi_bus_remove_device(b->device);
+    }
+    if (bus_ready) {
+        spi_bus_free(b->host);
+        gpio_reset_pin(static_cast<gpio_num_t>(b->gpio_pin));
+    }
+    for (int i = 0; i < NEOLED_SPI_QUEUE_DEPTH; i++) {
+        heap_caps_free(b->buffers[i]);
+    }
+    delete b;
+}
+
+/**
+ * @brief Claim the SPI host given as the port, with MOSI on the data pin
+ */
+static neoled_err_t spiInit(const neoled_backend_config_t* config, void** handle)
+{
+    if (config->port == SPI1_HOST || config->port < 0 || config->port >= SPI_HOST_MAX) {
+        ESP_LOGE(TAG, "Invalid SPI host %d", config->port);
+        return NEOLED_ERR_PARAM;
+    }
+
+    SpiBackend* b = new (std::nothrow) SpiBackend();
+    if (b == NULL) {
+        return NEOLED_ERR_NO_MEM;
+    }
+    b->host = (spi_host_device_t)config->port;
+    b->gpio_pin = config->gpio_pin;
+    b->buffer_bytes = config->frame_bytes;
+
+    for (int i = 0; i < NEOLED_SPI_QUEUE_DEPTH; i++) {
+        b->buffers[i] = static_cast<uint8_t*>(heap_caps_malloc(b->buffer_bytes, MALLOC_CAP_DMA));
+        if (b->buffers[i] == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate SPI DMA buffer");
+            spiRelease(b, false);
+            return NEOLED_ERR_NO_MEM;
+        }
+    }
+
+    spi_bus_config_t bus_cfg = {};
+    bus_cfg.mosi_io_num = config->gpio_pin;
+    bus_cfg.miso_io_num = -1;
+    bus_cfg.sclk_io_num = -1;
+    bus_cfg.quadwp_io_num = -1;
+    bus_cfg.quadhd_io_num = -1;
+    bus_cfg.max_transfer_sz = (int)b->buffer_bytes;
+
+    esp_err_t ret = spi_bus_initialize(b->host, &bus_cfg, SPI_DMA_CH_AUTO);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize SPI bus: %s", esp_err_to_name(ret));
+        spiRelease(b, false);
+        return NEOLED_ERR_INIT;
+    }
+
+    spi_device_interface_config_t dev_cfg = {};
+    dev_cfg.mode = 0;
+    dev_cfg.clock_speed_hz = (int)config->spi_clock_hz;
+    dev_cfg.spics_io_num = -1;
+    dev_cfg.queue_size = NEOLED_SPI_QUEUE_DEPTH;
+
+    ret = spi_bus_add_device(b->host, &dev_cfg, &b->device);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to add SPI device: %s", esp_err_to_name(ret));
+        b->device = NULL;
+        spiRelease(b, true);
+        return NEOLED_ERR_INIT;
+    }
+
+    *handle = b;
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Copy one SPI frame into a free DMA buffer and queue it
+ * @note Blocks only while all NEOLED_SPI_QUEUE_DEPTH buffers are in flight
+ */
+static neoled_err_t spiWrite(void* handle, const uint8_t* data, size_t length)
+{
+    SpiBackend* b = static_cast<SpiBackend*>(handle);
+
+    if (length > b->buffer_bytes) {
+        return NEOLED_ERR_PARAM;
+    }
+
+    // Slots are used round-robin and results come back in queue order, so
+    // reclaiming the oldest transaction frees exactly the next slot
+    if (b->in_flight == NEOLED_SPI_QUEUE_DEPTH && !spiReclaim(b, portMAX_DELAY)) {
+        return NEOLED_ERR_I2S;
+    }
+
+    uint8_t* buffer = b->buffers[b->next];
+    memcpy(buffer, data, length);
+
+    spi_transaction_t* t = &b->transactions[b->next];
+    memset(t, 0, sizeof(*t));
+    t->length = length * 8;
+    t->tx_buffer = buffer;
+
+    esp_err_t ret = spi_device_queue_trans(b->device, t, portMAX_DELAY);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "SPI queue failed: %s", esp_err_to_name(ret));
+        return NEOLED_ERR_I2S;
+    }
+
+    b->next = (b->next + 1) % NEOLED_SPI_QUEUE_DEPTH;
+    b->in_flight++;
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Wait for every queued frame to finish
+ */
+static neoled_err_t spiFlush(void* handle, uint32_t timeout_ms)
+{
+    SpiBackend* b = static_cast<SpiBackend*>(handle);
+    TickType_t timeout = (timeout_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+
+    while (b->in_flight > 0) {
+        if (!spiReclaim(b, timeout)) {
+            return NEOLED_ERR_TIMEOUT;
+        }
+    }
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Remove the device, free the bus and the DMA buffers
+ */
+static void spiDeinit(void* handle)
+{
+    SpiBackend* b = static_cast<SpiBackend*>(handle);
+
+    spiFlush(b, UINT32_MAX);
+    spiRelease(b, true);
+}
+
+static const neoled_backend_t spi_backend = {
+    "spi", NEOLED_FRAME_SPI, spiInit, spiWrite, spiFlush, spiDeinit
+};
+
+const neoled_backend_t* spiBackend(void)
+{
+    return &spi_backend;
+}
+#endif
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Encode one colour byte into its four I2S bytes (2-bit reference encoder)
+ * @param value Colour byte
+ * @param buffer Output buffer (must be at least 4 bytes)
+ */
+static inline void byteToBitPattern(uint8_t value, uint8_t* buffer)
+{
+    buffer[0] = bitpatterns[value >> 6 & 0x03];
+    buffer[1] = bitpatterns[value >> 4 & 0x03];
+    buffer[2] = bitpatterns[value >> 2 & 0x03];
+    buffer[3] = bitpatterns[value & 0x03];
+}
+
+/**
+ * @brief Encode one colour byte into a packed 32-bit I2S word
+ * @param value Colour byte
+ * @return Four encoded bytes, first byte on the wire in the lowest byte
+ */
+static inline uint32_t byteToWord(uint8_t value)
+{
+#if NEOLED_ENCODER_LUT
+    return byte_patterns[value];
+#else
+    uint8_t bytes[4];
+    byteToBitPattern(value, bytes);
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+           ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+#endif
+}
+
+/**
+ * @brief Encode one colour byte into a packed 32-bit I2S word for a protocol
+ * @param value Colour byte
+ * @param one_slots Slots high in a 1 bit (a 0 bit is one slot high)
+ * @return Four encoded bytes, first byte on the wire in the lowest byte
+ */
+static inline uint32_t byteToSlotWord(uint8_t value, uint8_t one_slots)
+{
+    if (one_slots == 3) {
+        return byteToWord(value);  // bitpatterns[]
+    }
+
+    // Two colour bits per byte, one nibble each: 1000 for 0, one_slots ones for 1
+    uint8_t zero = 0x8;
+    uint8_t one = (uint8_t)((0xf << (4 - one_slots)) & 0xf);
+    uint32_t word = 0;
+    for (int pair = 0; pair < 4; pair++) {
+        uint8_t bits = value >> (6 - 2 * pair) & 0x03;
+        uint8_t byte = (uint8_t)(((bits & 0x02) ? one : zero) << 4 | ((bits & 0x01) ? one : zero));
+        word |= (uint32_t)byte << (8 * pair);
+    }
+    return word;
+}
+
+/**
+ * @brief Encode one colour byte into its three SPI bytes
+ * @param value Colour byte
+ * @return Three encoded bytes, first byte on the wire in the lowest byte
+ */
+static inline uint32_t byteToSpiWord(uint8_t value)
+{
+    // Three SPI bits per colour bit, MSB first: 100 = 0, 110 = 1
+    uint32_t bits = 0;
+    for (int bit = 7; bit >= 0; bit--) {
+        bits = bits << 3 | ((value >> bit & 0x01) ? 0x6 : 0x4);
+    }
+    return (bits >> 16 & 0xff) | (bits & 0xff00) | (bits & 0xff) << 16;
+}
+
+/**
+ * @brief Store an encoded word into the output buffer
+ * @param buffer Output buffer (must be at least 4 bytes)
+ * @param word Encoded word from byteToWord() or the pipeline table
+ */
+static inline void storeWord(uint8_t* buffer, uint32_t word)
+{
+    // memcpy keeps this free of alignment/aliasing issues; the compiler
+    // lowers it to a single 32-bit store
+    memcpy(buffer, &word, sizeof(uint32_t));
+}
+
+/**
+ * @brief Repeat the leading bytes of a buffer up to its end
+ * @param buffer Buffer whose first unit bytes hold the pattern
+ * @param unit Pattern length in bytes
+ * @param total Length to fill, a multiple of unit
+ */
+static void replicate(uint8_t* buffer, size_t unit, size_t total)
+{
+    // Each copy doubles the filled part, so a frame takes log2(count) memcpy
+    // calls running at memory bandwidth
+    for (size_t filled = unit; filled < total; filled *= 2) {
+        size_t length = (filled < total - filled) ? filled : total - filled;
+        memcpy(&buffer[filled], buffer, length);
+    }
+}
+
+/**
+ * @brief Apply a gamma curve to a single colour value
+ * @param value Colour value (0-255)
+ * @param gamma Gamma value (1.0 = linear)
+ * @return Gamma-corrected value
+ */
+static uint8_t gammaValue(uint8_t value, float gamma)
+{
+    if (gamma == 1.0f) {
+        return value;
+    }
+    if (gamma == 2.2f) {
+        // Use lookup table for common gamma value
+        return gamma22_table[value];
+    }
+    // Calculate gamma for custom values
+    return (uint8_t)(powf(value / 255.0f, gamma) * 255.0f + 0.5f);
+}
+
+/**
+ * @brief Position of a colour value on a gamma curve, in 8.8 fixed point
+ * @param value Colour value (0-255)
+ * @param gamma Gamma value (1.0 = linear)
+ * @return Curve level times 256, which rounds to gammaValue()
+ */
+static uint16_t curveValue(uint8_t value, float gamma)
+{
+    int32_t level = gammaValue(value, gamma) << 8;
+    if (gamma == 1.0f || gamma == 2.2f) {
+        // gammaValue() is the curve itself here, not a rounding of it
+        return (uint16_t)level;
+    }
+    // Keep the fraction, but within half a step of gammaValue(), so output
+    // with and without dithering follows one curve
+    int32_t fine = (int32_t)(powf(value / 255.0f, gamma) * 65280.0f + 0.5f);
+    if (fine < level - 0x80) {
+        fine = level - 0x80;
+    }
+    if (fine > level + 0x7F) {
+        fine = level + 0x7F;
+    }
+    return (uint16_t)fine;
+}
+
+/**
+ * @brief Curve level rounded to a colour value, as gammaValue() returns it
+ */
+static inline uint32_t curveLevel(uint16_t curve)
+{
+    return (curve + 0x80) >> 8;
+}
+
+#if NEOLED_DITHER
+/**
+ * @brief Gamma-corrected, brightness-scaled colour value in 8.8 fixed point
+ * @param curve Colour value's 8.8 position on the gamma curve
+ * @param scale Brightness times the channel's white balance scale (0-65025)
+ * @return Output level times 256 (at most 255 << 8)
+ */
+static inline uint16_t ditherLevel(uint16_t curve, uint32_t scale)
+{
+    return (uint16_t)((curve * scale + 65025 / 2) / 65025);
+}
+#endif
+
+/**
+ * @brief Fill one channel's gamma curve and level tables
+ * @param gamma Channel gamma
+ * @param scale Channel white balance scale (255 = unchanged)
+ * @param curve Receives the 8.8 gamma curve position of each colour value
+ * @param levels Receives the corrected level of each colour value
+ */
+static void buildCurveTables(float gamma, uint8_t scale, uint16_t* curve, uint8_t* levels)
+{
+    for (int value = 0; value < 256; value++) {
+        curve[value] = curveValue((uint8_t)value, gamma);
+        levels[value] = (uint8_t)((curveLevel(curve[value]) * scale) / 255);
+    }
+}
+
+/**
+ * @brief Fill one channel's brightness-scaled pipeline tables from its curve
+ * @param s Strip state
+ * @param brightness Brightness multiplier (0-255)
+ * @param scale Channel white balance scale (255 = unchanged)
+ * @param curve Channel's gamma curve, from buildCurveTables()
+ * @param encode Receives the encoded word of each colour value
+ * @param dither Receives the 8.8 dithered output level of each colour value
+ *        (257 entries, ignored without NEOLED_DITHER)
+ */
+static void buildChannelTables(StripState* s, uint8_t brightness, uint8_t scale, const uint16_t* curve,
+                               uint32_t* encode, uint16_t* dither)
+{
+    for (int value = 0; value < 256; value++) {
+        uint8_t c = (uint8_t)((curveLevel(curve[value]) * scale * brightness) / (255 * 255));
+#if NEOLED_DITHER
+        if (s->dithering) {
+            // Scaling happens per frame in the dither table; this table only encodes
+            dither[value] = ditherLevel(curve[value], (uint32_t)brightness * scale);
+            c = (uint8_t)value;
+        }
+#else
+        (void)dither;
+#endif
+        switch (s->backend->format) {
+            case NEOLED_FRAME_GRB: encode[value] = c; break;
+            case NEOLED_FRAME_SPI: encode[value] = byteToSpiWord(c); break;
+            default: encode[value] = byteToSlotWord(c, s->protocol_info->one_slots); break;
+        }
+    }
+
+#if NEOLED_DITHER
+    dither[256] = dither[255];
+#endif
+}
+
+/**
+ * @brief Forget the frames kept for dirty tracking, whose encoding and level
+ *        sums no longer match the tables
+ * @param s Strip state
+ */
+static inline void forgetShown(StripState* s)
+{
+#if NEOLED_DIRTY_TRACKING
+    for (int b = 0; b < NEOLED_BUFFER_COUNT; b++) {
+        s->shown_valid[b] = false;
+    }
+#else
+    (void)s;
+#endif
+}
+
+/**
+ * @brief Rebuild the gamma curve and level tables if gamma or colour
+ *        correction changed
+ * @param s Strip state
+ * @note Neither depends on brightness, so a frame's level sum can be taken
+ *       before the power limiter picks its brightness, and a new brightness
+ *       does not recompute the curve
+ */
+static void prepareCurve(StripState* s)
+{
+    if (s->curve_valid && s->curve_gamma == s->gamma) {
+        return;
+    }
+
+    CorrectionTables* corrected = s->correction_tables;
+    if (corrected == NULL) {
+        buildCurveTables(s->gamma, 255, s->curve_table, s->level_table);
+        for (int channel = 0; channel < 4; channel++) {
+            s->tables.level[channel] = s->level_table;
+        }
+    } else {
+        for (int channel = 0; channel < s->protocol_info->channels; channel++) {
+            float gamma = s->correction_gamma[channel] != 0.0f ? s->correction_gamma[channel] : s->gamma;
+            buildCurveTables(gamma, s->correction_scale[channel], corrected->curve[channel],
+                             corrected->level[channel]);
+            s->tables.level[channel] = corrected->level[channel];
+        }
+    }
+
+    s->curve_gamma = s->gamma;
+    s->curve_valid = true;
+    s->pipeline_valid = false;
+    forgetShown(s);
+}
+
+/**
+ * @brief Check whether the pipeline tables match a brightness and the
+ *        strip's current settings
+ * @param s Strip state
+ * @param brightness Brightness multiplier (0-255)
+ * @return true if preparePipeline() would keep the tables
+ */
+static inline bool pipelineCurrent(const StripState* s, uint8_t brightness)
+{
+    return s->pipeline_valid && s->pipeline_brightness == brightness && s->curve_valid && s->curve_gamma == s->gamma
+#if NEOLED_DITHER
+        && s->pipeline_dither == s->dithering
+#endif
+        ;
+}
+
+/**
+ * @brief Rebuild the strip's colour pipeline tables if brightness, gamma,
+ *        colour correction or dithering changed
+ * @param s Strip state
+ * @param brightness Brightness multiplier (0-255)
+ * @return true if the table was rebuilt
+ */
+static bool preparePipeline(StripState* s, uint8_t brightness)
+{
+    prepareCurve(s);
+    if (pipelineCurrent(s, brightness)) {
+        return false;
+    }
+
+    CorrectionTables* corrected = s->correction_tables;
+    if (corrected == NULL) {
+        uint16_t* dither = NULL;
+#if NEOLED_DITHER
+        dither = s->dither_table;
+#endif
+        buildChannelTables(s, brightness, 255, s->curve_table, s->pipeline_table, dither);
+        for (int channel = 0; channel < 4; channel++) {
+            s->tables.encode[channel] = s->pipeline_table;
+#if NEOLED_DITHER
+            s->tables.dither[channel] = s->dither_table;
+#endif
+        }
+    } else {
+        for (int channel = 0; channel < s->protocol_info->channels; channel++) {
+            uint16_t* dither = NULL;
+#if NEOLED_DITHER
+            dither = corrected->dither[channel];
+            s->tables.dither[channel] = dither;
+#endif
+            buildChannelTables(s, brightness, s->correction_scale[channel], corrected->curve[channel],
+                               corrected->encode[channel], dither);
+            s->tables.encode[channel] = corrected->encode[channel];
+        }
+    }
+
+    s->pipeline_brightness = brightness;
+    s->pipeline_valid = true;
+#if NEOLED_DITHER
+    s->pipeline_dither = s->dithering;
+#endif
+
+    // A new table changes every encoding, so no previous frame can be reused
+    forgetShown(s);
+    return true;
+}
+
+/**
+ * @brief White channel of a pixel (off for RGB pixels)
+ */
+static inline uint8_t whiteOf(const Pixel&) { return 0; }
+static inline uint8_t whiteOf(const PixelW& pixel) { return pixel.white; }
+
+// Colour channels of a pixel, for ColourOrder
+enum { CHANNEL_RED, CHANNEL_GREEN, CHANNEL_BLUE, CHANNEL_WHITE };
+
+template <int Channel>
+struct ColourChannel;
+
+template <>
+struct ColourChannel<CHANNEL_RED> {
+    template <typename P> static inline uint8_t get(const P& pixel) { return pixel.red; }
+};
+
+template <>
+struct ColourChannel<CHANNEL_GREEN> {
+    template <typename P> static inline uint8_t get(const P& pixel) { return pixel.green; }
+};
+
+template <>
+struct ColourChannel<CHANNEL_BLUE> {
+    template <typename P> static inline uint8_t get(const P& pixel) { return pixel.blue; }
+};
+
+/**
+ * @brief Pixel type dirty tracking keeps for an order
+ */
+template <bool White>
+struct ShownPixel {
+    typedef Pixel Type;
+};
+
+template <>
+struct ShownPixel<true> {
+    typedef PixelW Type;
+};
+
+/**
+ * @brief Colour order: the channel an LED expects first, second and third,
+ *        then white for four-channel orders
+ * @note Resolved at compile time, so each order is its own encoder and
+ *       reordering costs nothing per pixel
+ */
+template <int First, int Second, int Third, bool White = false>
+struct ColourOrder {
+    typedef typename ShownPixel<White>::Type Shown;
+    static const size_t channels = White ? 4 : 3;
+    enum { first_channel = First, second_channel = Second, third_channel = Third };
+
+    template <typename P> static inline uint8_t first(const P& pixel) { return ColourChannel<First>::get(pixel); }
+    template <typename P> static inline uint8_t second(const P& pixel) { return ColourChannel<Second>::get(pixel); }
+    template <typename P> static inline uint8_t third(const P& pixel) { return ColourChannel<Third>::get(pixel); }
+};
+
+typedef ColourOrder<CHANNEL_GREEN, CHANNEL_RED, CHANNEL_BLUE> GRBOrder;
+
+/**
+ * @brief 16-bit channel value as an 8.8 fixed point position on the 0-255
+ *        scale (0xffff maps to exactly 255.0)
+ */
+static inline uint16_t fineValue(uint16_t value)
+{
+    return (uint16_t)(value - (value >> 8));
+}
+
+/**
+ * @brief 16-bit channel value rounded to the nearest 8-bit value
+ */
+static inline uint8_t roundValue(uint16_t value)
+{
+    return (uint8_t)((fineValue(value) + 0x80) >> 8);
+}
+
+/**
+ * @brief Pixel type an input pixel is encoded as without dithering
+ */
+template <typename P>
+struct EncodedPixel {
+    typedef P Type;
+};
+
+template <>
+struct EncodedPixel<Pixel16> {
+    typedef Pixel Type;
+};
+
+/**
+ * @brief Input pixel as encoded without dithering (16-bit input is rounded
+ *        to 8 bits in the encode loop, with no intermediate array)
+ */
+static inline const Pixel& encodedPixel(const Pixel& pixel) { return pixel; }
+static inline const PixelW& encodedPixel(const PixelW& pixel) { return pixel; }
+
+static inline Pixel encodedPixel(const Pixel16& pixel)
+{
+    Pixel out;
+    out.green = roundValue(pixel.green);
+    out.red = roundValue(pixel.red);
+    out.blue = roundValue(pixel.blue);
+    return out;
+}
+
+/**
+ * @brief Compare a new pixel with the one last encoded (an RGB pixel on an
+ *        RGBW strip has the white channel off)
+ */
+static inline bool samePixel(const Pixel& shown, const Pixel& pixel)
+{
+    return shown.green == pixel.green && shown.red == pixel.red && shown.blue == pixel.blue;
+}
+
+static inline bool samePixel(const PixelW& shown, const Pixel& pixel)
+{
+    return shown.green == pixel.green && shown.red == pixel.red && shown.blue == pixel.blue && shown.white == 0;
+}
+
+static inline bool samePixel(const PixelW& shown, const PixelW& pixel)
+{
+    return shown.green == pixel.green && shown.red == pixel.red && shown.blue == pixel.blue &&
+           shown.white == pixel.white;
+}
+
+/**
+ * @brief Record a pixel as last encoded
+ */
+static inline void setShown(Pixel& shown, const Pixel& pixel)
+{
+    shown = pixel;
+}
+
+static inline void setShown(PixelW& shown, const Pixel& pixel)
+{
+    shown.green = pixel.green;
+    shown.red = pixel.red;
+    shown.blue = pixel.blue;
+    shown.white = 0;
+}
+
+static inline void setShown(PixelW& shown, const PixelW& pixel)
+{
+    shown = pixel;
+}
+
+/**
+ * @brief Sum of a pixel's gamma-corrected channel levels, for the power limiter
+ */
+static inline uint32_t pixelLevel(const ChannelTables& tables, const Pixel& pixel)
+{
+    return tables.level[CHANNEL_GREEN][pixel.green] + tables.level[CHANNEL_RED][pixel.red] +
+           tables.level[CHANNEL_BLUE][pixel.blue];
+}
+
+static inline uint32_t pixelLevel(const ChannelTables& tables, const PixelW& pixel)
+{
+    return tables.level[CHANNEL_GREEN][pixel.green] + tables.level[CHANNEL_RED][pixel.red] +
+           tables.level[CHANNEL_BLUE][pixel.blue] + tables.level[CHANNEL_WHITE][pixel.white];
+}
+
+/**
+ * @brief I2S frame layout: four encoded bytes per channel (PIXEL_SIZE for RGB)
+ */
+template <typename Order>
+struct I2SFrame {
+    typedef typename Order::Shown Shown;
+    static const size_t pixel_bytes = Order::channels * 4;
+
+    template <typename P>
+    static inline void store(const ChannelTables& tables, const P& pixel, uint8_t* buffer)
+    {
+        storeWord(&buffer[0], tables.encode[Order::first_channel][Order::first(pixel)]);
+        storeWord(&buffer[4], tables.encode[Order::second_channel][Order::second(pixel)]);
+        storeWord(&buffer[8], tables.encode[Order::third_channel][Order::third(pixel)]);
+        if (Order::channels == 4) {
+            storeWord(&buffer[12], tables.encode[CHANNEL_WHITE][whiteOf(pixel)]);
+        }
+    }
+};
+
+/**
+ * @brief Colour frame layout: one byte per channel
+ */
+template <typename Order>
+struct ColourFrame {
+    typedef typename Order::Shown Shown;
+    static const size_t pixel_bytes = Order::channels;
+
+    template <typename P>
+    static inline void store(const ChannelTables& tables, const P& pixel, uint8_t* buffer)
+    {
+        buffer[0] = (uint8_t)tables.encode[Order::first_channel][Order::first(pixel)];
+        buffer[1] = (uint8_t)tables.encode[Order::second_channel][Order::second(pixel)];
+        buffer[2] = (uint8_t)tables.encode[Order::third_channel][Order::third(pixel)];
+        if (Order::channels == 4) {
+            buffer[3] = (uint8_t)tables.encode[CHANNEL_WHITE][whiteOf(pixel)];
+        }
+    }
+};
+
+/**
+ * @brief SPI frame layout: three encoded bytes per channel
+ *        (NEOLED_SPI_PIXEL_SIZE for RGB)
+ */
+template <typename Order>
+struct SpiFrame {
+    typedef typename Order::Shown Shown;
+    static const size_t pixel_bytes = Order::channels * 3;
+
+    template <typename P>
+    static inline void store(const ChannelTables& tables, const P& pixel, uint8_t* buffer)
+    {
+        // Three bytes per channel; a 32-bit store would spill into the next LED
+        memcpy(&buffer[0], &tables.encode[Order::first_channel][Order::first(pixel)], 3);
+        memcpy(&buffer[3], &tables.encode[Order::second_channel][Order::second(pixel)], 3);
+        memcpy(&buffer[6], &tables.encode[Order::third_channel][Order::third(pixel)], 3);
+        if (Order::channels == 4) {
+            memcpy(&buffer[9], &tables.encode[CHANNEL_WHITE][whiteOf(pixel)], 3);
+        }
+    }
+};
+
+#if NEOLED_DITHER
+// Rounding offsets for the 16 dither steps, in bit-reversed order so any run
+// of frames spreads its round-ups evenly (a level's fraction f rounds up in
+// about f * 16 of every 16 frames)
+static const uint8_t dither_phases[16] = {
+    8, 136, 72, 200, 40, 168, 104, 232, 24, 152, 88, 216, 56, 184, 120, 248
+};
+
+/**
+ * @brief Last pixel sent, kept for dithering as 8.8 fixed point positions on
+ *        the 0-255 colour scale so 16-bit input keeps its low bits
+ */
+template <typename Shown>
+struct DitherSource;
+
+template <>
+struct DitherSource<Pixel> {
+    uint16_t green;
+    uint16_t red;
+    uint16_t blue;
+};
+
+template <>
+struct DitherSource<PixelW> {
+    uint16_t green;
+    uint16_t red;
+    uint16_t blue;
+    uint16_t white;
+};
+
+/**
+ * @brief Record a pixel as the dither source
+ */
+static inline void setDitherSource(DitherSource<Pixel>& source, const Pixel& pixel)
+{
+    source.green = (uint16_t)(pixel.green << 8);
+    source.red = (uint16_t)(pixel.red << 8);
+    source.blue = (uint16_t)(pixel.blue << 8);
+}
+
+static inline void setDitherSource(DitherSource<Pixel>& source, const Pixel16& pixel)
+{
+    source.green = fineValue(pixel.green);
+    source.red = fineValue(pixel.red);
+    source.blue = fineValue(pixel.blue);
+}
+
+static inline void setDitherSource(DitherSource<PixelW>& source, const Pixel& pixel)
+{
+    source.green = (uint16_t)(pixel.green << 8);
+    source.red = (uint16_t)(pixel.red << 8);
+    source.blue = (uint16_t)(pixel.blue << 8);
+    source.white = 0;
+}
+
+static inline void setDitherSource(DitherSource<PixelW>& source, const PixelW& pixel)
+{
+    source.green = (uint16_t)(pixel.green << 8);
+    source.red = (uint16_t)(pixel.red << 8);
+    source.blue = (uint16_t)(pixel.blue << 8);
+    source.white = (uint16_t)(pixel.white << 8);
+}
+
+static inline void setDitherSource(DitherSource<PixelW>& source, const Pixel16& pixel)
+{
+    source.green = fineValue(pixel.green);
+    source.red = fineValue(pixel.red);
+    source.blue = fineValue(pixel.blue);
+    source.white = 0;
+}
+
+/**
+ * @brief Dither source rounded to the nearest 8-bit pixel
+ */
+static inline uint8_t roundFine(uint16_t value)
+{
+    return (uint8_t)((value + 0x80) >> 8);  // Sources never exceed 255.0
+}
+
+static inline void setShownFromDither(Pixel& shown, const DitherSource<Pixel>& source)
+{
+    shown.green = roundFine(source.green);
+    shown.red = roundFine(source.red);
+    shown.blue = roundFine(source.blue);
+}
+
+static inline void setShownFromDither(PixelW& shown, const DitherSource<PixelW>& source)
+{
+    shown.green = roundFine(source.green);
+    shown.red = roundFine(source.red);
+    shown.blue = roundFine(source.blue);
+    shown.white = roundFine(source.white);
+}
+
+/**
+ * @brief Round one channel's 8.8 level up or down for this dither step
+ * @param levels dither_table
+ * @param value 8.8 position on the colour scale (at most 255 << 8)
+ * @param phase Rounding offset from dither_phases
+ */
+static inline uint8_t ditherChannel(const uint16_t* levels, uint16_t value, uint8_t phase)
+{
+    // Interpolate between the two table entries around the position
+    uint16_t index = value >> 8;
+    uint32_t low = levels[index];
+    uint32_t level = low + (((levels[index + 1] - low) * (value & 0xFF)) >> 8);
+    return (uint8_t)((level + phase) >> 8);
+}
+
+/**
+ * @brief Dithered output values of a pixel, for encoding with the bit-only table
+ */
+static inline Pixel ditherPixel(const ChannelTables& tables, const DitherSource<Pixel>& pixel, uint8_t phase)
+{
+    Pixel out;
+    out.green = ditherChannel(tables.dither[CHANNEL_GREEN], pixel.green, phase);
+    out.red = ditherChannel(tables.dither[CHANNEL_RED], pixel.red, phase);
+    out.blue = ditherChannel(tables.dither[CHANNEL_BLUE], pixel.blue, phase);
+    return out;
+}
+
+static inline PixelW ditherPixel(const ChannelTables& tables, const DitherSource<PixelW>& pixel, uint8_t phase)
+{
+    PixelW out;
+    out.green = ditherChannel(tables.dither[CHANNEL_GREEN], pixel.green, phase);
+    out.red = ditherChannel(tables.dither[CHANNEL_RED], pixel.red, phase);
+    out.blue = ditherChannel(tables.dither[CHANNEL_BLUE], pixel.blue, phase);
+    out.white = ditherChannel(tables.dither[CHANNEL_WHITE], pixel.white, phase);
+    return out;
+}
+
+static inline uint32_t pixelLevel(const ChannelTables& tables, const DitherSource<Pixel>& pixel)
+{
+    return tables.level[CHANNEL_GREEN][pixel.green >> 8] + tables.level[CHANNEL_RED][pixel.red >> 8] +
+           tables.level[CHANNEL_BLUE][pixel.blue >> 8];
+}
+
+static inline uint32_t pixelLevel(const ChannelTables& tables, const DitherSource<PixelW>& pixel)
+{
+    return tables.level[CHANNEL_GREEN][pixel.green >> 8] + tables.level[CHANNEL_RED][pixel.red >> 8] +
+           tables.level[CHANNEL_BLUE][pixel.blue >> 8] + tables.level[CHANNEL_WHITE][pixel.white >> 8];
+}
+#endif
+
+/**
+ * @brief LEDs encoded per write: one streaming chunk, or the whole strip
+ * @param s Strip state
+ */
+static inline uint16_t chunkLeds(const StripState* s)
+{
+    return (s->stream_leds != 0 && s->stream_leds < s->led_count) ? s->stream_leds : s->led_count;
+}
+
+/**
+ * @brief Size the DMA descriptors for the strip's encoded frame length
+ * @param s Strip state
+ * @note Uses the fewest descriptors of at most NEOLED_DMA_DESC_BYTES that hold
+ *       one whole frame (NEOLED_STREAM_DEPTH chunks when streaming), balanced
+ *       to equal length; NEOLED_DMA_DESC_NUM_MAX caps the count so only part
+ *       of a frame is buffered
+ */
+static void computeDmaLayout(StripState* s)
+{
+    uint32_t max_frames = NEOLED_DMA_DESC_BYTES / I2S_SAMPLE_BYTES;
+    uint32_t samples = (uint32_t)((s->frame_bytes + I2S_SAMPLE_BYTES - 1) / I2S_SAMPLE_BYTES);
+    if (s->stream_leds != 0) {
+        // A ring of NEOLED_STREAM_DEPTH chunks, whatever the strip length
+        size_t chunk_bytes = (size_t)chunkLeds(s) * s->pixel_bytes;
+        samples = NEOLED_STREAM_DEPTH * (uint32_t)((chunk_bytes + I2S_SAMPLE_BYTES - 1) / I2S_SAMPLE_BYTES);
+    }
+
+    uint32_t desc_num = (samples + max_frames - 1) / max_frames;
+    if (NEOLED_DMA_DESC_NUM_MAX > 0 && desc_num > NEOLED_DMA_DESC_NUM_MAX) {
+        desc_num = NEOLED_DMA_DESC_NUM_MAX;
+    }
+    if (desc_num < 2) {
+        desc_num = 2;  // Both I2S drivers need at least two descriptors
+    }
+
+    uint32_t frame_num = (samples + desc_num - 1) / desc_num;
+    if (frame_num > max_frames) {
+        frame_num = max_frames;
+    }
+    if (frame_num < 8) {
+        frame_num = 8;  // Legacy driver minimum
+    }
+
+    s->dma_desc_num = desc_num;
+    s->dma_frame_num = frame_num;
+    ESP_LOGD(TAG, "DMA: %u descriptors x %u bytes", (unsigned)desc_num, (unsigned)(frame_num * I2S_SAMPLE_BYTES));
+}
+
+/**
+ * @brief Allocate the strip's frame buffers on first use
+ * @param s Strip state
+ * @return NEOLED_OK on success, NEOLED_ERR_NO_MEM if allocation failed
+ * @note Buffers are kept across destroy()/init() and freed with the Strip.
+ *       A streaming strip gets a single chunk buffer and no dirty tracking.
+ */
+static neoled_err_t allocateBuffers(StripState* s)
+{
+    if (s->out_buffers[0] != NULL) {
+        return NEOLED_OK;
+    }
+
+    if (s->stream_leds != 0) {
+        // One chunk, with room for the reset that follows the last one
+        size_t chunk_size = (size_t)chunkLeds(s) * s->pixel_bytes + s->reset_bytes;
+        s->out_buffers[0] = (uint8_t*)heap_caps_calloc(1, chunk_size, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+        if (s->out_buffers[0] == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate %u bytes of DMA memory", (unsigned)chunk_size);
+            return NEOLED_ERR_NO_MEM;
+        }
+        return NEOLED_OK;
+    }
+
+    // The frames are followed by room to save the bytes a prefix's reset displaces
+    size_t frames_size = NEOLED_BUFFER_COUNT * s->buffer_stride + s->reset_bytes;
+    uint8_t* frames = (uint8_t*)heap_caps_calloc(1, frames_size, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+    if (frames == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate %u bytes of DMA memory", (unsigned)frames_size);
+        return NEOLED_ERR_NO_MEM;
+    }
+
+#if NEOLED_DIRTY_TRACKING
+    size_t shown_bytes = (size_t)s->led_count * s->protocol_info->channels;
+    uint8_t* shown = (uint8_t*)heap_caps_calloc(NEOLED_BUFFER_COUNT, shown_bytes, MALLOC_CAP_8BIT);
+    if (shown == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate dirty tracking buffer");
+        heap_caps_free(frames);
+        return NEOLED_ERR_NO_MEM;
+    }
+#endif
+
+    s->reset_save = frames + NEOLED_BUFFER_COUNT * s->buffer_stride;
+    for (int b = 0; b < NEOLED_BUFFER_COUNT; b++) {
+        s->out_buffers[b] = frames + b * s->buffer_stride;
+#if NEOLED_DIRTY_TRACKING
+        s->shown_pixels[b] = shown + b * shown_bytes;
+        s->shown_valid[b] = false;
+#endif
+    }
+
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Allocate the driver-owned pixels on first use, all off
+ * @param s Strip state
+ * @return NEOLED_OK on success, NEOLED_ERR_NO_MEM if allocation failed
+ */
+static neoled_err_t allocateFramebuffer(StripState* s)
+{
+    if (s->framebuffer != NULL) {
+        return NEOLED_OK;
+    }
+
+    size_t bytes = (size_t)s->led_count * s->protocol_info->channels;
+    s->framebuffer = (uint8_t*)heap_caps_calloc(1, bytes, MALLOC_CAP_8BIT);
+    if (s->framebuffer == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate %u byte framebuffer", (unsigned)bytes);
+        return NEOLED_ERR_NO_MEM;
+    }
+    s->framebuffer_shared = false;
+#if NEOLED_DIRTY_TRACKING
+    for (int b = 0; b < NEOLED_BUFFER_COUNT; b++) {
+        s->framebuffer_dirty_end[b] = s->led_count;
+    }
+#endif
+    return NEOLED_OK;
+}
+
+#if NEOLED_DITHER
+/**
+ * @brief Allocate the copy of the last pixels that dithered frames encode from
+ * @param s Strip state
+ * @return NEOLED_OK on success, NEOLED_ERR_NO_MEM if allocation failed
+ */
+static neoled_err_t allocateDitherPixels(StripState* s)
+{
+    if (s->dither_pixels != NULL) {
+        return NEOLED_OK;
+    }
+
+    size_t bytes = (size_t)s->led_count * s->protocol_info->channels * sizeof(uint16_t);
+    s->dither_pixels = (uint8_t*)heap_caps_calloc(1, bytes, MALLOC_CAP_8BIT);
+    if (s->dither_pixels == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate dither buffer");
+        return NEOLED_ERR_NO_MEM;
+    }
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Hand the frame on the LEDs between the dither source and the dirty
+ *        tracking copy when dithering is switched on or off
+ * @tparam Shown Pixel or PixelW, the strip's shown pixel layout
+ * @param s Strip state (initialized, dither_pixels allocated)
+ * @param enable true to seed the dither source, false to copy it back
+ * @return true if the frame was copied
+ * @note Without dirty tracking there is no copy of an undithered frame, so
+ *       the source is only known once a frame has been sent with dithering
+ */
+template <typename Shown>
+static bool handOverDitherSource(StripState* s, bool enable)
+{
+#if NEOLED_DIRTY_TRACKING
+    DitherSource<Shown>* source = reinterpret_cast<DitherSource<Shown>*>(s->dither_pixels);
+    Shown* shown = reinterpret_cast<Shown*>(s->shown_pixels[s->active_buffer]);
+    for (uint16_t i = 0; i < s->led_count; i++) {
+        if (enable) {
+            setDitherSource(source[i], shown[i]);
+        } else {
+            setShownFromDither(shown[i], source[i]);
+        }
+    }
+    return true;
+#else
+    (void)s;
+    (void)enable;
+    return false;
+#endif
+}
+#endif
+
+/**
+ * @brief Free the strip's frame buffers
+ * @param s Strip state
+ */
+static void freeBuffers(StripState* s)
+{
+    // Each set of buffers is a single allocation starting at buffer 0
+    heap_caps_free(s->out_buffers[0]);
+#if NEOLED_DIRTY_TRACKING
+    heap_caps_free(s->shown_pixels[0]);
+#endif
+#if NEOLED_DITHER
+    heap_caps_free(s->dither_pixels);
+    s->dither_pixels = NULL;
+    s->dither_seeded = false;
+#endif
+    s->reset_save = NULL;
+    for (int b = 0; b < NEOLED_BUFFER_COUNT; b++) {
+        s->out_buffers[b] = NULL;
+#if NEOLED_DIRTY_TRACKING
+        s->shown_pixels[b] = NULL;
+#endif
+    }
+}
+
+#if NEOLED_DITHER
+/**
+ * @brief Encode the first count dither source pixels with the next dither step
+ * @tparam Frame Frame layout (I2SFrame, ColourFrame or SpiFrame of a colour order)
+ * @param s Strip state (pipeline and dither tables already prepared)
+ * @param buffer Index into out_buffers
+ * @param count Number of pixels to encode
+ * @return count: a dithered frame changes from one step to the next
+ */
+template <typename Frame>
+static uint16_t encodeDithered(StripState* s, int buffer, uint16_t count)
+{
+    const DitherSource<typename Frame::Shown>* source =
+        reinterpret_cast<const DitherSource<typename Frame::Shown>*>(s->dither_pixels);
+    const ChannelTables tables = s->tables;
+    uint8_t* out_buffer = s->out_buffers[buffer];
+    uint8_t step = s->dither_step++;
+    uint32_t frame_levels = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        // Neighbouring LEDs run the sequence out of step, so a strip at one
+        // level does not round up all at once
+        uint8_t phase = dither_phases[(step + i * 7) & 15];
+        Frame::store(tables, ditherPixel(tables, source[i], phase), &out_buffer[i * Frame::pixel_bytes]);
+        frame_levels += pixelLevel(tables, source[i]);
+    }
+    s->frame_levels = frame_levels;
+
+#if NEOLED_DIRTY_TRACKING
+    s->shown_valid[buffer] = false;
+#endif
+    s->skipped_pixels = 0;
+    return count;
+}
+
+/**
+ * @brief Record the first count pixels as the dither source and encode them
+ * @tparam Frame Frame layout (I2SFrame, ColourFrame or SpiFrame of a colour order)
+ * @tparam P Pixel, PixelW or Pixel16
+ * @param s Strip state (pipeline and dither tables already prepared)
+ * @param buffer Index into out_buffers
+ * @param pixels Source pixel array (at least count pixels), NULL to re-encode
+ *        the last pixels sent
+ * @param count Number of pixels to encode
+ * @return count, see encodeDithered()
+ */
+template <typename Frame, typename P>
+static uint16_t ditherPixelRange(StripState* s, int buffer, const P* pixels, uint16_t count)
+{
+    if (pixels != NULL) {
+        DitherSource<typename Frame::Shown>* source =
+            reinterpret_cast<DitherSource<typename Frame::Shown>*>(s->dither_pixels);
+        for (uint16_t i = 0; i < count; i++) {
+            setDitherSource(source[i], pixels[i]);
+        }
+        s->dither_seeded = true;
+    }
+    return encodeDithered<Frame>(s, buffer, count);
+}
+#endif
+
+/**
+ * @brief Encode the first count pixels into a frame buffer in one layout
+ * @tparam Frame Frame layout (I2SFrame, ColourFrame or SpiFrame of a colour order)
+ * @tparam P Pixel, PixelW or Pixel16
+ * @param s Strip state (pipeline table already prepared)
+ * @param buffer Index into out_buffers
+ * @param pixels Source pixel array (at least count pixels)
+ * @param count Number of pixels to encode
+ * @return Number of leading LEDs that must be sent to show the frame
+ *         (one past the highest changed pixel, 0 if nothing changed)
+ */
+template <typename Frame, typename P>
+static uint16_t encodePixelRange(StripState* s, int buffer, const P* pixels, uint16_t count)
+{
+#if NEOLED_DITHER
+    if (s->dithering) {
+        return ditherPixelRange<Frame>(s, buffer, pixels, count);
+    }
+#endif
+
+    const ChannelTables tables = s->tables;
+    uint8_t* out_buffer = s->out_buffers[buffer];
+
+#if NEOLED_DIRTY_TRACKING
+    // Streamed chunks are not kept, so there is no previous frame to compare with
+    if (s->stream_leds == 0) {
+        // Convert changed pixels to bit patterns, moving the level sum by the
+        // difference each one makes
+        typename Frame::Shown* shown_pixels = reinterpret_cast<typename Frame::Shown*>(s->shown_pixels[buffer]);
+        bool shown_valid = s->shown_valid[buffer];
+        uint32_t frame_levels = shown_valid ? s->shown_levels[buffer] : 0;
+        uint16_t skipped = 0;
+        uint16_t dirty_end = 0;
+
+        // The buffer holds the frame it last sent, but the LEDs show the last
+        // frame encoded; with two buffers in turn (updateAsync) that is the
+        // other one, and the prefix to send is measured against it
+        int sent = s->active_buffer;
+        const typename Frame::Shown* sent_pixels = NULL;
+        if (sent != buffer && s->shown_valid[sent]) {
+            sent_pixels = reinterpret_cast<const typename Frame::Shown*>(s->shown_pixels[sent]);
+        }
+
+        for (uint16_t i = 0; i < count; i++) {
+            typename EncodedPixel<P>::Type pixel = encodedPixel(pixels[i]);
+            typename Frame::Shown& shown = shown_pixels[i];
+            if (sent_pixels != NULL && !samePixel(sent_pixels[i], pixel)) {
+                dirty_end = i + 1;
+            }
+            if (shown_valid && samePixel(shown, pixel)) {
+                skipped++;
+                continue;
+            }
+            if (shown_valid) {
+                frame_levels -= pixelLevel(tables, shown);
+            }
+            frame_levels += pixelLevel(tables, pixel);
+            setShown(shown, pixel);
+            Frame::store(tables, pixel, &out_buffer[i * Frame::pixel_bytes]);
+            if (sent == buffer) {
+                dirty_end = i + 1;
+            }
+        }
+
+        // A partial range leaves the tail untouched, so it is only a valid
+        // baseline once every pixel has been encoded against the current table;
+        // without a baseline for the frame on the LEDs, all of it is sent
+        if (count == s->led_count) {
+            s->shown_valid[buffer] = true;
+        }
+        if ((sent == buffer) ? !shown_valid && count != s->led_count : sent_pixels == NULL) {
+            dirty_end = count;
+        }
+        s->shown_levels[buffer] = frame_levels;
+        s->frame_levels = frame_levels;
+        s->skipped_pixels = skipped;
+        return dirty_end;
+    }
+#endif
+
+    // Convert all pixels to bit patterns
+    uint32_t frame_levels = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        typename EncodedPixel<P>::Type pixel = encodedPixel(pixels[i]);
+        Frame::store(tables, pixel, &out_buffer[i * Frame::pixel_bytes]);
+        frame_levels += pixelLevel(tables, pixel);
+    }
+    s->frame_levels = frame_levels;
+    return count;
+}
+
+/**
+ * @brief Run the strip's encoder for a pixel type
+ */
+static inline uint16_t encodeRange(StripState* s, int buffer, const Pixel* pixels, uint16_t count)
+{
+    return s->encode_range(s, buffer, pixels, count);
+}
+
+static inline uint16_t encodeRange(StripState* s, int buffer, const PixelW* pixels, uint16_t count)
+{
+    return s->encode_range_w(s, buffer, pixels, count);
+}
+
+#if NEOLED_PIXEL16
+static inline uint16_t encodeRange(StripState* s, int buffer, const Pixel16* pixels, uint16_t count)
+{
+    return s->encode_range16(s, buffer, pixels, count);
+}
+#endif
+
+/**
+ * @brief Highest brightness at which a frame stays within the power budget
+ * @param s Strip state
+ * @param brightness Requested brightness (0-255)
+ * @param levels Sum of the frame's gamma-corrected channel levels
+ * @return brightness, or the largest lower value that fits the budget
+ */
+static uint8_t powerLimit(const StripState* s, uint8_t brightness, uint32_t levels)
+{
+    if (s->power_limit_ma == 0) {
+        return brightness;
+    }
+
+    // A frame draws levels * brightness * channel_ma / (255 * 255) mA
+    uint64_t per_step = (uint64_t)levels * s->channel_ma;
+    uint64_t budget = (uint64_t)s->power_limit_ma * 255 * 255;
+    if (per_step * brightness <= budget) {
+        return brightness;
+    }
+    return (uint8_t)(budget / per_step);
+}
+
+/**
+ * @brief Estimated current of the last frame encoded, in mA
+ */
+static uint32_t frameCurrent(const StripState* s, uint8_t brightness)
+{
+    return (uint32_t)((uint64_t)s->frame_levels * brightness * s->channel_ma / (255 * 255));
+}
+
+/**
+ * @brief Number of leading pixels to encode, fewer than count when the
+ *        source is the framebuffer and setPixel() recorded every change
+ * @param s Strip state
+ * @param buffer Index into out_buffers
+ * @param pixels Source pixel array
+ * @param count Number of pixels to update
+ * @return count, or one past the last LED set since the framebuffer was
+ *         last encoded into the buffer
+ * @note The tail past the returned count is not looked at, which holds only
+ *       while the buffer's tables stay as they are
+ */
+template <typename P>
+static uint16_t framebufferChanged(const StripState* s, int buffer, const P* pixels, uint16_t count)
+{
+#if NEOLED_DIRTY_TRACKING
+    // Only when the buffer also holds the frame on the LEDs (not showAsync(),
+    // where the prefix to send depends on the other buffer)
+    bool tracked = pixels == (const void*)s->framebuffer && !s->framebuffer_shared && count == s->led_count &&
+                   buffer == s->active_buffer;
+    if (tracked && s->shown_valid[buffer]
+#if NEOLED_DITHER
+        && !s->dithering
+#endif
+    ) {
+        return s->framebuffer_dirty_end[buffer];
+    }
+#else
+    (void)s;
+    (void)buffer;
+    (void)pixels;
+#endif
+    return count;
+}
+
+/**
+ * @brief Sum of the gamma-corrected channel levels of the first count pixels
+ * @param s Strip state (level tables already prepared)
+ */
+template <typename P>
+static uint32_t sumLevels(const StripState* s, const P* pixels, uint16_t count)
+{
+    uint32_t levels = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        levels += pixelLevel(s->tables, encodedPixel(pixels[i]));
+    }
+    return levels;
+}
+
+/**
+ * @brief Level sum of a frame before it is encoded, for the power limiter
+ * @tparam Shown Pixel type dirty tracking keeps for the strip's colour order
+ * @tparam P Pixel, PixelW or Pixel16
+ * @param s Strip state (level tables already prepared)
+ * @param buffer Index into out_buffers
+ * @param pixels Source pixel array, NULL to re-encode the last pixels sent
+ * @param count Number of leading pixels that may have changed
+ * @return The buffer's last sum moved by each pixel that differs from the
+ *         one it replaces, or the sum of every pixel without that baseline
+ */
+template <typename Shown, typename P>
+static uint32_t changedLevels(const StripState* s, int buffer, const P* pixels, uint16_t count)
+{
+    if (pixels == NULL) {
+        return s->frame_levels;
+    }
+#if NEOLED_DIRTY_TRACKING
+    if (s->shown_valid[buffer]) {
+        // Only compares: the changed pixels are encoded once the brightness is known
+        const Shown* shown = reinterpret_cast<const Shown*>(s->shown_pixels[buffer]);
+        uint32_t levels = s->shown_levels[buffer];
+        for (uint16_t i = 0; i < count; i++) {
+            typename EncodedPixel<P>::Type pixel = encodedPixel(pixels[i]);
+            if (!samePixel(shown[i], pixel)) {
+                levels = levels - pixelLevel(s->tables, shown[i]) + pixelLevel(s->tables, pixel);
+            }
+        }
+        return levels;
+    }
+#else
+    (void)buffer;
+#endif
+    return sumLevels(s, pixels, count);
+}
+
+/**
+ * @brief changedLevels() for the pixel type the strip's colour order keeps
+ */
+template <typename P>
+static inline uint32_t frameLevels(const StripState* s, int buffer, const P* pixels, uint16_t count)
+{
+    return (s->protocol_info->channels == 4) ? changedLevels<PixelW>(s, buffer, pixels, count)
+                                             : changedLevels<Pixel>(s, buffer, pixels, count);
+}
+
+static inline uint32_t frameLevels(const StripState* s, int buffer, const PixelW* pixels, uint16_t count)
+{
+    return changedLevels<PixelW>(s, buffer, pixels, count);  // Only RGBW strips take RGBW pixels
+}
+
+/**
+ * @brief Encode the first count pixels into one of the strip's frame buffers
+ * @tparam P Pixel, PixelW or Pixel16
+ * @param s Strip state
+ * @param buffer Index into out_buffers
+ * @param pixels Source pixel array (at least count pixels), NULL to re-encode
+ *        the last pixels sent when dithering
+ * @param count Number of pixels to encode
+ * @param brightness Brightness multiplier (0-255), lowered for this frame if
+ *        it would exceed the power budget
+ * @return Number of leading LEDs that must be sent to show the frame
+ *         (one past the highest changed pixel, 0 if nothing changed)
+ */
+template <typename P>
+static uint16_t encodePixels(StripState* s, int buffer, const P* pixels, uint16_t count, uint8_t brightness)
+{
+    prepareCurve(s);
+    uint16_t encode_count = framebufferChanged(s, buffer, pixels, count);
+
+    // Levels do not depend on brightness, so the frame's sum is known before
+    // encoding: the pixels that changed move the buffer's last sum, and the
+    // frame is encoded once, at the brightness that fits
+    uint8_t limited = brightness;
+    if (s->power_limit_ma != 0) {
+        limited = powerLimit(s, brightness, frameLevels(s, buffer, pixels, encode_count));
+    }
+    if (preparePipeline(s, limited)) {
+        encode_count = count;
+    }
+    uint16_t dirty_end = encodeRange(s, buffer, pixels, encode_count);
+
+    s->frame_current_ma = frameCurrent(s, limited);
+#if NEOLED_DIRTY_TRACKING
+    if (s->framebuffer != NULL) {
+        s->framebuffer_dirty_end[buffer] = (pixels == (const void*)s->framebuffer) ? 0 : s->led_count;
+    }
+#endif
+    return dirty_end;
+}
+
+/**
+ * @brief Encode one colour into the leading LEDs of a frame buffer in one layout
+ * @tparam Frame Frame layout (I2SFrame, ColourFrame or SpiFrame of a colour order)
+ * @param s Strip state (pipeline table already prepared)
+ * @param buffer Index into out_buffers
+ * @param colour Colour for all LEDs
+ * @param count LEDs to encode: the whole strip, or one chunk when streaming
+ */
+template <typename Frame>
+static void encodeSolidRange(StripState* s, int buffer, const Pixel& colour, uint16_t count)
+{
+#if NEOLED_DITHER
+    if (s->dithering) {
+        DitherSource<typename Frame::Shown>* source =
+            reinterpret_cast<DitherSource<typename Frame::Shown>*>(s->dither_pixels);
+        for (uint16_t i = 0; i < s->led_count; i++) {
+            setDitherSource(source[i], colour);
+        }
+        s->dither_seeded = true;
+        encodeDithered<Frame>(s, buffer, s->led_count);
+        return;
+    }
+#endif
+
+    // Every LED encodes to the same bytes: encode one and copy it
+    uint8_t* out_buffer = s->out_buffers[buffer];
+    Frame::store(s->tables, colour, out_buffer);
+    replicate(out_buffer, Frame::pixel_bytes, (size_t)count * Frame::pixel_bytes);
+    s->frame_levels = s->led_count * pixelLevel(s->tables, colour);
+
+#if NEOLED_DIRTY_TRACKING
+    if (s->stream_leds != 0) {
+        return;
+    }
+    typename Frame::Shown* shown_pixels = reinterpret_cast<typename Frame::Shown*>(s->shown_pixels[buffer]);
+    setShown(shown_pixels[0], colour);
+    replicate(reinterpret_cast<uint8_t*>(shown_pixels), sizeof(typename Frame::Shown),
+              (size_t)s->led_count * sizeof(typename Frame::Shown));
+    s->shown_valid[buffer] = true;
+    s->shown_levels[buffer] = s->frame_levels;
+#endif
+}
+
+/**
+ * @brief Encode one pixel in place in a frame buffer in one layout
+ * @tparam Frame Frame layout (I2SFrame, ColourFrame or SpiFrame of a colour order)
+ * @tparam P Pixel or PixelW
+ * @param s Strip state (pipeline table already prepared)
+ * @param buffer Index into out_buffers
+ * @param index LED to encode
+ * @param pixel New colour of the LED
+ */
+template <typename Frame, typename P>
+static void encodePixelAt(StripState* s, int buffer, uint16_t index, const P& pixel)
+{
+    Frame::store(s->tables, pixel, &s->out_buffers[buffer][index * Frame::pixel_bytes]);
+
+#if NEOLED_DIRTY_TRACKING
+    // Keep the buffer's comparison baseline and level sum in step, so later
+    // updates still skip unchanged pixels and the current estimate holds
+    if (s->shown_valid[buffer]) {
+        typename Frame::Shown& shown = reinterpret_cast<typename Frame::Shown*>(s->shown_pixels[buffer])[index];
+        s->shown_levels[buffer] -= pixelLevel(s->tables, shown);
+        s->shown_levels[buffer] += pixelLevel(s->tables, pixel);
+        setShown(shown, pixel);
+        s->frame_levels = s->shown_levels[buffer];
+    }
+#endif
+}
+
+/**
+ * @brief Encode one colour into every LED of one of the strip's frame buffers
+ *        (the first chunk's LEDs when streaming)
+ * @param s Strip state
+ * @param buffer Index into out_buffers
+ * @param colour Colour for all LEDs
+ * @param brightness Brightness multiplier (0-255)
+ */
+static void encodeSolid(StripState* s, int buffer, const Pixel& colour, uint8_t brightness)
+{
+    // The level sum is known up front, so the budget applies before encoding
+    prepareCurve(s);
+    uint8_t limited = powerLimit(s, brightness, s->led_count * pixelLevel(s->tables, colour));
+    preparePipeline(s, limited);
+    s->encode_solid(s, buffer, colour, chunkLeds(s));
+    s->frame_current_ma = frameCurrent(s, limited);
+    s->skipped_pixels = 0;
+#if NEOLED_DIRTY_TRACKING
+    s->framebuffer_dirty_end[buffer] = s->led_count;
+#endif
+}
+
+// ============================================================================
+// LED Protocols
+// ============================================================================
+
+/**
+ * @brief Reset samples for an I2S frame: reset_us of zero samples, rounded up
+ */
+static constexpr size_t i2sResetBytes(uint32_t reset_us, uint32_t sample_rate)
+{
+    return (size_t)(((uint64_t)reset_us * sample_rate + 999999ULL) / 1000000ULL) * I2S_SAMPLE_BYTES;
+}
+
+/**
+ * @brief Reset bytes for an SPI frame: reset_us of zero bits, rounded up
+ */
+static constexpr size_t spiResetBytes(uint32_t reset_us, uint32_t spi_clock_hz)
+{
+    return (size_t)(((uint64_t)reset_us * spi_clock_hz + 7999999ULL) / 8000000ULL);
+}
+
+/**
+ * @brief Compile-time protocol parameters, one specialisation per chip
+ * @note sample_rate and one_slots approximate the bit timing with four I2S
+ *       slots per bit, spi_clock_hz with three SPI bits (one or two high)
+ */
+template <neoled_protocol_t Protocol>
+struct ProtocolTraits;
+
+template <>
+struct ProtocolTraits<NEOLED_WS2812> {
+    static const neoled_color_order_t order = NEOLED_ORDER_GRB;
+    static const uint8_t channels = 3;
+    static const uint32_t t0h_ns = 400;
+    static const uint32_t t1h_ns = 800;
+    static const uint32_t bit_ns = 1250;
+    static const uint32_t reset_us = NEOLED_RESET_US;
+    static const uint32_t sample_rate = SAMPLE_RATE;           // 0.33/1.0 us of 1.33 us
+    static const uint8_t one_slots = 3;
+    static const size_t i2s_reset_bytes = ZERO_BUFFER;
+    static const uint32_t spi_clock_hz = NEOLED_SPI_CLOCK_HZ;  // 0.42/0.83 us of 1.25 us
+    static const size_t spi_reset_bytes = NEOLED_SPI_RESET_BYTES;
+};
+
+template <>
+struct ProtocolTraits<NEOLED_SK6812> {
+    static const neoled_color_order_t order = NEOLED_ORDER_GRB;
+    static const uint8_t channels = 3;
+    static const uint32_t t0h_ns = 300;
+    static const uint32_t t1h_ns = 600;
+    static const uint32_t bit_ns = 1250;
+    static const uint32_t reset_us = 80;
+    static const uint32_t sample_rate = 100000;                // 0.31/0.63 us of 1.25 us
+    static const uint8_t one_slots = 2;
+    static const size_t i2s_reset_bytes = i2sResetBytes(reset_us, sample_rate);
+    static const uint32_t spi_clock_hz = 2400000;              // 0.42/0.83 us of 1.25 us
+    static const size_t spi_reset_bytes = spiResetBytes(reset_us, spi_clock_hz);
+};
+
+template <>
+struct ProtocolTraits<NEOLED_WS2811> {
+    static const neoled_color_order_t order = NEOLED_ORDER_RGB;
+    static const uint8_t channels = 3;
+    static const uint32_t t0h_ns = 500;
+    static const uint32_t t1h_ns = 1200;
+    static const uint32_t bit_ns = 2500;
+    static const uint32_t reset_us = 300;
+    static const uint32_t sample_rate = 50000;                 // 0.63/1.25 us of 2.5 us
+    static const uint8_t one_slots = 2;
+    static const size_t i2s_reset_bytes = i2sResetBytes(reset_us, sample_rate);
+    static const uint32_t spi_clock_hz = 1200000;              // 0.83/1.67 us of 2.5 us
+    static const size_t spi_reset_bytes = spiResetBytes(reset_us, spi_clock_hz);
+};
+
+template <>
+struct ProtocolTraits<NEOLED_WS2815> {
+    static const neoled_color_order_t order = NEOLED_ORDER_GRB;
+    static const uint8_t channels = 3;
+    static const uint32_t t0h_ns = 300;
+    static const uint32_t t1h_ns = 750;
+    static const uint32_t bit_ns = 1250;
+    static const uint32_t reset_us = 280;
+    static const uint32_t sample_rate = 100000;                // 0.31/0.94 us of 1.25 us
+    static const uint8_t one_slots = 3;
+    static const size_t i2s_reset_bytes = i2sResetBytes(reset_us, sample_rate);
+    static const uint32_t spi_clock_hz = 2400000;              // 0.42/0.83 us of 1.25 us
+    static const size_t spi_reset_bytes = spiResetBytes(reset_us, spi_clock_hz);
+};
+
+template <>
+struct ProtocolTraits<NEOLED_APA106> {
+    static const neoled_color_order_t order = NEOLED_ORDER_RGB;
+    static const uint8_t channels = 3;
+    static const uint32_t t0h_ns = 350;
+    static const uint32_t t1h_ns = 1360;
+    static const uint32_t bit_ns = 1710;
+    static const uint32_t reset_us = 50;
+    static const uint32_t sample_rate = 73000;                 // 0.43/1.28 us of 1.71 us
+    static const uint8_t one_slots = 3;
+    static const size_t i2s_reset_bytes = i2sResetBytes(reset_us, sample_rate);
+    static const uint32_t spi_clock_hz = 1750000;              // 0.57/1.14 us of 1.71 us
+    static const size_t spi_reset_bytes = spiResetBytes(reset_us, spi_clock_hz);
+};
+
+template <>
+struct ProtocolTraits<NEOLED_SK6812_RGBW> : ProtocolTraits<NEOLED_SK6812> {
+    static const uint8_t channels = 4;
+};
+
+typedef uint16_t (*EncodeRangeW)(StripState* s, int buffer, const PixelW* pixels, uint16_t count);
+
+/**
+ * @brief RGBW pixel encoder for a frame layout (none for RGB layouts)
+ */
+template <typename Frame>
+static EncodeRangeW whiteEncoder(const Pixel*)
+{
+    return NULL;
+}
+
+template <typename Frame>
+static EncodeRangeW whiteEncoder(const PixelW*)
+{
+    return encodePixelRange<Frame, PixelW>;
+}
+
+typedef void (*EncodePixelW)(StripState* s, int buffer, uint16_t index, const PixelW& pixel);
+
+/**
+ * @brief In-place RGBW pixel encoder for a frame layout (none for RGB layouts)
+ */
+template <typename Frame>
+static EncodePixelW whitePixelEncoder(const Pixel*)
+{
+    return NULL;
+}
+
+template <typename Frame>
+static EncodePixelW whitePixelEncoder(const PixelW*)
+{
+    return encodePixelAt<Frame, PixelW>;
+}
+
+/**
+ * @brief Point the strip's encoders at one frame layout
+ */
+template <typename Frame>
+static void useFrame(StripState* s)
+{
+    s->pixel_bytes = Frame::pixel_bytes;
+    s->encode_range = encodePixelRange<Frame, Pixel>;
+    s->encode_range_w = whiteEncoder<Frame>(static_cast<const typename Frame::Shown*>(NULL));
+#if NEOLED_PIXEL16
+    s->encode_range16 = encodePixelRange<Frame, Pixel16>;
+#endif
+    s->encode_solid = encodeSolidRange<Frame>;
+    s->encode_pixel = encodePixelAt<Frame, Pixel>;
+    s->encode_pixel_w = whitePixelEncoder<Frame>(static_cast<const typename Frame::Shown*>(NULL));
+}
+
+/**
+ * @brief Choose the encoders for a colour order and the backend's frame format
+ */
+template <typename Order>
+static void selectEncoders(StripState* s)
+{
+    switch (s->backend->format) {
+        case NEOLED_FRAME_GRB: useFrame<ColourFrame<Order> >(s); break;
+        case NEOLED_FRAME_SPI: useFrame<SpiFrame<Order> >(s); break;
+        default: useFrame<I2SFrame<Order> >(s); break;
+    }
+}
+
+/**
+ * @brief Choose the encoders for one of the six colour orders
+ * @tparam White true for four-channel (RGBW) protocols
+ */
+template <bool White>
+static void selectOrder(StripState* s, neoled_color_order_t order)
+{
+    switch (order) {
+        case NEOLED_ORDER_RGB: selectEncoders<ColourOrder<CHANNEL_RED, CHANNEL_GREEN, CHANNEL_BLUE, White> >(s); break;
+#if NEOLED_COLOR_ORDERS
+        case NEOLED_ORDER_RBG: selectEncoders<ColourOrder<CHANNEL_RED, CHANNEL_BLUE, CHANNEL_GREEN, White> >(s); break;
+        case NEOLED_ORDER_GBR: selectEncoders<ColourOrder<CHANNEL_GREEN, CHANNEL_BLUE, CHANNEL_RED, White> >(s); break;
+        case NEOLED_ORDER_BRG: selectEncoders<ColourOrder<CHANNEL_BLUE, CHANNEL_RED, CHANNEL_GREEN, White> >(s); break;
+        case NEOLED_ORDER_BGR: selectEncoders<ColourOrder<CHANNEL_BLUE, CHANNEL_GREEN, CHANNEL_RED, White> >(s); break;
+#endif
+        default: selectEncoders<ColourOrder<CHANNEL_GREEN, CHANNEL_RED, CHANNEL_BLUE, White> >(s); break;
+    }
+}
+
+/**
+ * @brief Get the parameters of one protocol
+ */
+template <neoled_protocol_t Protocol>
+static const ProtocolInfo* protocolInfo(void)
+{
+    typedef ProtocolTraits<Protocol> Traits;
+    static const ProtocolInfo info = {
+        Traits::channels, Traits::t0h_ns, Traits::t1h_ns, Traits::bit_ns, Traits::reset_us,
+        Traits::sample_rate, Traits::one_slots, Traits::i2s_reset_bytes,
+        Traits::spi_clock_hz, Traits::spi_reset_bytes, Traits::order
+    };
+    return &info;
+}
+
+/**
+ * @brief Look up a protocol's parameters
+ * @return Parameters, or NULL for an unknown protocol
+ */
+static const ProtocolInfo* lookupProtocol(neoled_protocol_t protocol)
+{
+    switch (protocol) {
+        case NEOLED_WS2812: return protocolInfo<NEOLED_WS2812>();
+        case NEOLED_SK6812: return protocolInfo<NEOLED_SK6812>();
+        case NEOLED_WS2811: return protocolInfo<NEOLED_WS2811>();
+        case NEOLED_WS2815: return protocolInfo<NEOLED_WS2815>();
+        case NEOLED_APA106: return protocolInfo<NEOLED_APA106>();
+        case NEOLED_SK6812_RGBW: return protocolInfo<NEOLED_SK6812_RGBW>();
+        default: return NULL;
+    }
+}
+
+/**
+ * @brief Size the strip's frames and pick its encoders for its protocol and
+ *        backend frame format
+ * @param s Strip state
+ * @note Frees buffers sized for another layout and invalidates the pipeline
+ *       table, whose entries depend on both
+ */
+static void applyFrameFormat(StripState* s)
+{
+    const ProtocolInfo* protocol = s->protocol_info;
+    size_t old_frame_bytes = s->frame_bytes;
+    size_t old_reset_bytes = s->reset_bytes;
+
+    neoled_color_order_t order = s->color_order != NEOLED_ORDER_DEFAULT ? s->color_order : protocol->order;
+    if (protocol->channels == 4) {
+        selectOrder<true>(s, order);
+    } else {
+        selectOrder<false>(s, order);
+    }
+    switch (s->backend->format) {
+        case NEOLED_FRAME_GRB: s->reset_bytes = 0; break;
+        case NEOLED_FRAME_SPI: s->reset_bytes = protocol->spi_reset_bytes; break;
+        default: s->reset_bytes = protocol->i2s_reset_bytes; break;
+    }
+    s->frame_bytes = (size_t)s->led_count * s->pixel_bytes + s->reset_bytes;
+    s->buffer_stride = (s->frame_bytes + 3) & ~(size_t)3;
+    s->pipeline_valid = false;
+    s->curve_valid = false;  // A white channel may have joined or left
+
+    // Buffers are reallocated at the next init
+    if (s->frame_bytes != old_frame_bytes || s->reset_bytes != old_reset_bytes) {
+        freeBuffers(s);
+    }
+}
+
+/**
+ * @brief Send the first count encoded LEDs followed by the reset signal
+ * @param s Strip state
+ * @param out_buffer Encoded frame buffer
+ * @param count Number of leading LEDs to send (0 sends nothing)
+ * @return NEOLED_OK on success, the backend's error on write failure
+ * @note LEDs past count keep their latched colour
+ */
+static neoled_err_t transmit(StripState* s, uint8_t* out_buffer, uint16_t count)
+{
+    if (count == 0) {
+        return NEOLED_OK;  // Nothing changed, the strip already shows this frame
+    }
+
+    size_t length = (size_t)count * s->pixel_bytes;
+
+    // In I2S and SPI frames the reset bytes must directly follow the last
+    // sent LED. A full frame already ends in them; a prefix borrows the next
+    // LEDs' bytes for the write, which is safe because backends copy or send
+    // the data before returning. Colour frames leave the reset to the backend.
+    bool prefix = s->reset_bytes > 0 && count < s->led_count;
+    if (prefix) {
+        memcpy(s->reset_save, &out_buffer[length], s->reset_bytes);
+        memset(&out_buffer[length], 0, s->reset_bytes);
+    }
+
+    neoled_err_t ret = s->backend->write(s->backend_handle, out_buffer, length + s->reset_bytes);
+
+    if (prefix) {
+        memcpy(&out_buffer[length], s->reset_save, s->reset_bytes);
+    }
+
+    if (ret != NEOLED_OK) {
+        return ret;
+    }
+
+    // No latch delay or DMA clear needed: the reset is part of the write and
+    // auto-clear keeps the line low once the DMA runs out of data
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Encode time a streaming strip can spend on one chunk before the
+ *        backend runs out of data
+ * @param s Strip state (streaming)
+ * @return Wire time of the chunks still queued when a write returns, in us
+ */
+static uint32_t streamSlack(const StripState* s)
+{
+    // A write returns once its chunk is queued; the chunks ahead of it cover
+    // the encode of the next one
+    uint64_t chunk_bytes = (uint64_t)chunkLeds(s) * s->pixel_bytes;
+    const ProtocolInfo* protocol = s->protocol_info;
+    if (s->backend->format == NEOLED_FRAME_SPI) {
+        return (uint32_t)((NEOLED_SPI_QUEUE_DEPTH - 1) * chunk_bytes * 8000000ULL / protocol->spi_clock_hz);
+    }
+    return (uint32_t)((NEOLED_STREAM_DEPTH - 1) * chunk_bytes * 1000000ULL /
+                      ((uint64_t)protocol->sample_rate * I2S_SAMPLE_BYTES));
+}
+
+/**
+ * @brief Write one streamed chunk, followed by the reset if it ends the frame
+ * @param s Strip state (streaming)
+ * @param count LEDs encoded at the start of out_buffers[0]
+ * @param last true for the frame's last chunk
+ * @return NEOLED_OK on success, the backend's error on write failure
+ */
+static neoled_err_t writeChunk(StripState* s, uint16_t count, bool last)
+{
+    uint8_t* chunk = s->out_buffers[0];
+    size_t length = (size_t)count * s->pixel_bytes;
+    if (last) {
+        // The chunk buffer has room for the reset after a full chunk
+        memset(&chunk[length], 0, s->reset_bytes);
+        length += s->reset_bytes;
+    }
+    return s->backend->write(s->backend_handle, chunk, length);
+}
+
+/**
+ * @brief Encode pixels one chunk at a time, writing each as soon as it is encoded
+ * @tparam P Pixel, PixelW or Pixel16
+ * @param s Strip state (streaming)
+ * @param pixels Source pixel array (at least count pixels)
+ * @param count Number of leading pixels to send
+ * @param brightness Brightness multiplier (0-255), lowered for this frame if
+ *        it would exceed the power budget
+ * @return NEOLED_OK on success, the backend's error on write failure
+ * @note The backend's write blocks while its DMA ring is full, so each chunk
+ *       is encoded as soon as the previous one has been queued, while the ring
+ *       drains. A chunk that takes longer than stream_slack_us lets the line go
+ *       idle mid-frame and is counted as an underrun.
+ */
+template <typename P>
+static neoled_err_t streamPixels(StripState* s, const P* pixels, uint16_t count, uint8_t brightness)
+{
+    // The first chunks are on the wire before the last one is encoded, so a
+    // sum taken while encoding could only limit the next frame, after the
+    // supply had been overdrawn. Streaming therefore makes one extra pass over
+    // the pixels for the budget; it only reads the level tables.
+    uint8_t limited = brightness;
+    if (s->power_limit_ma != 0) {
+        prepareCurve(s);
+        limited = powerLimit(s, brightness, sumLevels(s, pixels, count));
+    }
+    preparePipeline(s, limited);
+
+    uint16_t chunk_leds = chunkLeds(s);
+    uint32_t frame_levels = 0;
+    uint32_t longest_us = 0;
+    neoled_err_t ret = NEOLED_OK;
+    for (uint32_t first = 0; first < count && ret == NEOLED_OK; first += chunk_leds) {
+        uint16_t n = (uint16_t)(count - first < chunk_leds ? count - first : chunk_leds);
+
+        int64_t start = esp_timer_get_time();
+        encodeRange(s, 0, &pixels[first], n);
+        uint32_t encode_us = (uint32_t)(esp_timer_get_time() - start);
+        frame_levels += s->frame_levels;
+
+        if (encode_us > longest_us) {
+            longest_us = encode_us;
+        }
+        // The first chunk is encoded before anything is queued
+        if (first > 0 && encode_us > s->stream_slack_us) {
+            if (s->stream_underruns == 0) {
+                ESP_LOGW(TAG, "Stream underrun: chunk took %u us, the DMA ring covers %u us",
+                         (unsigned)encode_us, (unsigned)s->stream_slack_us);
+            }
+            s->stream_underruns++;
+        }
+
+        ret = writeChunk(s, n, first + n == count);
+    }
+
+    s->stream_encode_us = longest_us;
+    s->frame_levels = frame_levels;
+    s->frame_current_ma = frameCurrent(s, limited);
+    s->skipped_pixels = 0;
+    return ret;
+}
+
+/**
+ * @brief Send one colour to every LED, one chunk at a time
+ * @param s Strip state (streaming)
+ * @param colour Colour for all LEDs
+ * @param brightness Brightness multiplier (0-255)
+ * @return NEOLED_OK on success, the backend's error on write failure
+ * @note Every chunk is the same, so it is encoded once and written repeatedly
+ */
+static neoled_err_t streamSolid(StripState* s, const Pixel& colour, uint8_t brightness)
+{
+    encodeSolid(s, 0, colour, brightness);
+
+    uint16_t chunk_leds = chunkLeds(s);
+    neoled_err_t ret = NEOLED_OK;
+    for (uint32_t first = 0; first < s->led_count && ret == NEOLED_OK; first += chunk_leds) {
+        uint16_t n = (uint16_t)(s->led_count - first < chunk_leds ? s->led_count - first : chunk_leds);
+        ret = writeChunk(s, n, first + n == s->led_count);
+    }
+    return ret;
+}
+
+#if NEOLED_ASYNC
+/**
+ * @brief Writer task: sends frames queued by updateAsync() in order
+ * @param arg Strip state
+ */
+static void writerTask(void* arg)
+{
+    StripState* s = static_cast<StripState*>(arg);
+    FrameJob job;
+
+    while (xQueueReceive(s->frame_queue, &job, portMAX_DELAY) == pdTRUE) {
+        if (job.buffer == WRITER_STOP) {
+            break;
+        }
+
+        neoled_err_t result = transmit(s, s->out_buffers[job.buffer], job.count);
+
+        // Release the buffer before the callback so it may queue the next frame
+        xSemaphoreGive(s->buffer_free[job.buffer]);
+        if (s->update_callback != nullptr) {
+            s->update_callback(result, s->update_callback_arg);
+        }
+    }
+
+    xSemaphoreGive(s->writer_exit);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Wait until no frame is queued or on the wire and claim all buffers
+ * @param s Strip state
+ * @param timeout Maximum time to wait
+ * @return true if all buffers were claimed, false on timeout
+ */
+static bool claimBuffers(StripState* s, TickType_t timeout)
+{
+    for (int b = 0; b < NEOLED_BUFFER_COUNT; b++) {
+        if (xSemaphoreTake(s->buffer_free[b], timeout) != pdTRUE) {
+            while (--b >= 0) {
+                xSemaphoreGive(s->buffer_free[b]);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Release buffers claimed by claimBuffers()
+ * @param s Strip state
+ */
+static void releaseBuffers(StripState* s)
+{
+    for (int b = 0; b < NEOLED_BUFFER_COUNT; b++) {
+        xSemaphoreGive(s->buffer_free[b]);
+    }
+}
+
+/**
+ * @brief Delete the writer task and its synchronisation objects
+ * @param s Strip state
+ */
+static void stopWriter(StripState* s)
+{
+    if (s->frame_queue != NULL && s->writer_exit != NULL) {
+        FrameJob stop = {WRITER_STOP, 0};
+        if (xQueueSend(s->frame_queue, &stop, portMAX_DELAY) == pdTRUE) {
+            xSemaphoreTake(s->writer_exit, portMAX_DELAY);
+        }
+    }
+
+    if (s->frame_queue != NULL) {
+        vQueueDelete(s->frame_queue);
+        s->frame_queue = NULL;
+    }
+    if (s->writer_exit != NULL) {
+        vSemaphoreDelete(s->writer_exit);
+        s->writer_exit = NULL;
+    }
+    for (int b = 0; b < NEOLED_BUFFER_COUNT; b++) {
+        if (s->buffer_free[b] != NULL) {
+            vSemaphoreDelete(s->buffer_free[b]);
+            s->buffer_free[b] = NULL;
+        }
+    }
+}
+
+/**
+ * @brief Create the writer task and its synchronisation objects
+ * @param s Strip state
+ * @return NEOLED_OK on success, NEOLED_ERR_NO_MEM if any allocation failed
+ */
+static neoled_err_t startWriter(StripState* s)
+{
+    for (int b = 0; b < NEOLED_BUFFER_COUNT; b++) {
+        s->buffer_free[b] = xSemaphoreCreateBinary();
+        if (s->buffer_free[b] == NULL) {
+            stopWriter(s);
+            return NEOLED_ERR_NO_MEM;
+        }
+        xSemaphoreGive(s->buffer_free[b]);
+    }
+
+    s->frame_queue = xQueueCreate(NEOLED_BUFFER_COUNT, sizeof(FrameJob));
+    s->writer_exit = xSemaphoreCreateBinary();
+    if (s->frame_queue == NULL || s->writer_exit == NULL) {
+        stopWriter(s);
+        return NEOLED_ERR_NO_MEM;
+    }
+
+    // One writer per port, named after it so the tasks can be told apart
+    char name[16];
+    snprintf(name, sizeof(name), "neoled_tx%d", s->port);
+
+    if (xTaskCreate(writerTask, name, NEOLED_TASK_STACK_SIZE, s,
+                    NEOLED_TASK_PRIORITY, NULL) != pdPASS) {
+        // No task to stop, so drop the queue before stopWriter() posts to it
+        vQueueDelete(s->frame_queue);
+        s->frame_queue = NULL;
+        stopWriter(s);
+        return NEOLED_ERR_NO_MEM;
+    }
+
+    return NEOLED_OK;
+}
+#endif
+
+/**
+ * @brief Let the last frame reach the LEDs, then shut the backend down
+ * @param s Strip state
+ */
+static void deinitBackend(StripState* s)
+{
+    s->backend->flush(s->backend_handle, UINT32_MAX);
+    s->backend->deinit(s->backend_handle);
+    s->backend_handle = NULL;
+}
+
+/**
+ * @brief Check whether the render task sends the strip's frames, so other
+ *        tasks must not
+ * @param s Strip state
+ * @return true (and logs) while the render task runs
+ */
+static inline bool renderOwned(const StripState* s)
+{
+#if NEOLED_RENDER
+    if (s->render_running) {
+        ESP_LOGE(TAG, "The render task sends this strip's frames, use submitFrame()");
+        return true;
+    }
+#else
+    (void)s;
+#endif
+    return false;
+}
+
+/**
+ * @brief Check whether the render task runs, so the settings it reads for
+ *        each frame must not change
+ * @param s Strip state
+ * @return true (and logs) while the render task runs
+ */
+static inline bool renderSettingsLocked(const StripState* s)
+{
+#if NEOLED_RENDER
+    if (s->render_running) {
+        ESP_LOGE(TAG, "The render task uses this strip's settings, call stopRender() first");
+        return true;
+    }
+#else
+    (void)s;
+#endif
+    return false;
+}
+
+/**
+ * @brief Check whether encoded framebuffer mode is on, so the encoding of the
+ *        LEDs already in the buffer must not change
+ * @param s Strip state
+ * @return true (and logs) in encoded framebuffer mode
+ */
+static inline bool encodedSettingsLocked(const StripState* s)
+{
+    if (s->encoded_framebuffer) {
+        ESP_LOGE(TAG, "Encoded framebuffer mode keeps the encoding fixed, call setEncodedFramebuffer(false) first");
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Check that a strip can take a full update
+ * @param s Strip state (may be NULL)
+ * @param pixels Source pixel array
+ * @param rgbw true for PixelW arrays, which need a four-channel protocol
+ * @return NEOLED_OK, NEOLED_ERR_NOT_INIT or NEOLED_ERR_PARAM
+ */
+static neoled_err_t checkUpdate(const StripState* s, const void* pixels, bool rgbw)
+{
+    if (s == nullptr || !s->initialized) {
+        ESP_LOGE(TAG, "Not initialized");
+        return NEOLED_ERR_NOT_INIT;
+    }
+
+    if (renderOwned(s)) {
+        return NEOLED_ERR_PARAM;
+    }
+
+    if (pixels == nullptr) {
+        ESP_LOGE(TAG, "Null pixel pointer");
+        return NEOLED_ERR_PARAM;
+    }
+
+    if (rgbw && s->encode_range_w == NULL) {
+        ESP_LOGE(TAG, "RGBW pixels need an RGBW protocol");
+        return NEOLED_ERR_PARAM;
+    }
+
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Encode pixels and send them synchronously
+ * @tparam P Pixel, PixelW or Pixel16
+ * @param s Strip state
+ * @param pixels Source pixel array (at least count pixels)
+ * @param count Number of leading pixels to update
+ * @param brightness Brightness multiplier (0-255)
+ * @return NEOLED_OK on success, error code otherwise
+ */
+template <typename P>
+static neoled_err_t showPixels(StripState* s, const P* pixels, uint16_t count, uint8_t brightness)
+{
+#if NEOLED_ASYNC
+    // Let queued asynchronous frames finish so frames reach the wire in order
+    claimBuffers(s, portMAX_DELAY);
+#endif
+
+    neoled_err_t ret;
+    if (s->stream_leds != 0) {
+        ret = streamPixels(s, pixels, count, brightness);
+    } else {
+        uint16_t dirty_end = encodePixels(s, s->active_buffer, pixels, count, brightness);
+        uint16_t send_count = s->auto_prefix ? dirty_end : count;
+        ret = transmit(s, s->out_buffers[s->active_buffer], send_count);
+    }
+
+#if NEOLED_ASYNC
+    releaseBuffers(s);
+#endif
+
+    return ret;
+}
+
+/**
+ * @brief Set every LED to one colour and send the frame synchronously
+ * @param s Strip state
+ * @param colour Colour for all LEDs
+ * @param brightness Brightness multiplier (0-255)
+ * @return NEOLED_OK on success, error code otherwise
+ */
+static neoled_err_t showSolid(StripState* s, const Pixel& colour, uint8_t brightness)
+{
+#if NEOLED_ASYNC
+    claimBuffers(s, portMAX_DELAY);
+#endif
+
+    neoled_err_t ret;
+    if (s->stream_leds != 0) {
+        ret = streamSolid(s, colour, brightness);
+    } else {
+        encodeSolid(s, s->active_buffer, colour, brightness);
+        ret = transmit(s, s->out_buffers[s->active_buffer], s->led_count);
+    }
+
+#if NEOLED_ASYNC
+    releaseBuffers(s);
+#endif
+
+    return ret;
+}
+
+#if NEOLED_RENDER
+// Render triple buffer: render_middle holds a slot index, with RENDER_FRESH
+// set while the slot is a submitted frame the task has not taken yet
+enum { RENDER_SLOTS = 3, RENDER_SLOT_MASK = 0x03, RENDER_FRESH = 0x80 };
+
+/**
+ * @brief Render task: encodes and sends the newest submitted frame
+ * @param arg Strip state
+ */
+static void renderTask(void* arg)
+{
+    StripState* s = static_cast<StripState*>(arg);
+
+    // Settings are fixed while the task runs, so the wait is worked out once
+    TickType_t wait = portMAX_DELAY;
+#if NEOLED_DITHER
+    if (s->dithering && s->dither_refresh_ms != 0) {
+        wait = pdMS_TO_TICKS(s->dither_refresh_ms);
+        wait = wait != 0 ? wait : 1;
+    }
+#endif
+
+    for (;;) {
+        if (xSemaphoreTake(s->render_wake, wait) != pdTRUE) {
+#if NEOLED_DITHER
+            // No new frame in time: keep the dither sequence of the last one going
+            if (s->dither_seeded) {
+                showPixels(s, (const Pixel*)NULL, s->led_count, s->pipeline_brightness);
+            }
+#endif
+            continue;
+        }
+
+        // Read before the slot: stopRender() sets the flag after the last
+        // submitFrame(), so once it is seen that frame is seen too
+        bool stopping = s->render_stop.load(std::memory_order_acquire);
+
+        // Frames submitted while the last one was sent have replaced each
+        // other in the middle slot; only the newest is left to take
+        if (s->render_middle.load(std::memory_order_acquire) & RENDER_FRESH) {
+            uint8_t taken = s->render_middle.exchange(s->render_front, std::memory_order_acq_rel);
+            s->render_front = taken & RENDER_SLOT_MASK;
+
+            const uint8_t* frame = s->render_slots[s->render_front];
+            if (s->protocol_info->channels == 4) {
+                showPixels(s, reinterpret_cast<const PixelW*>(frame), s->led_count, s->brightness);
+            } else {
+                showPixels(s, reinterpret_cast<const Pixel*>(frame), s->led_count, s->brightness);
+            }
+        }
+
+        if (stopping) {
+            break;
+        }
+    }
+
+    xSemaphoreGive(s->render_exit);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Free the render slots and semaphores
+ * @param s Strip state (render task not running)
+ */
+static void freeRender(StripState* s)
+{
+    for (int i = 0; i < RENDER_SLOTS; i++) {
+        heap_caps_free(s->render_slots[i]);
+        s->render_slots[i] = NULL;
+    }
+    if (s->render_wake != NULL) {
+        vSemaphoreDelete(s->render_wake);
+        s->render_wake = NULL;
+    }
+    if (s->render_exit != NULL) {
+        vSemaphoreDelete(s->render_exit);
+        s->render_exit = NULL;
+    }
+}
+
+/**
+ * @brief Send the last submitted frame, then delete the render task
+ * @param s Strip state
+ */
+static void stopRenderTask(StripState* s)
+{
+    if (!s->render_running) {
+        return;
+    }
+
+    s->render_stop.store(true, std::memory_order_release);
+    xSemaphoreGive(s->render_wake);
+    xSemaphoreTake(s->render_exit, portMAX_DELAY);
+
+    s->render_running = false;
+    freeRender(s);
+}
+
+/**
+ * @brief Allocate the render slots and create the render task
+ * @param s Strip state (initialized)
+ * @param core Core to pin the task to, or tskNO_AFFINITY
+ * @return NEOLED_OK on success, NEOLED_ERR_NO_MEM if any allocation failed
+ */
+static neoled_err_t startRenderTask(StripState* s, int core)
+{
+    size_t bytes = (size_t)s->led_count * s->protocol_info->channels;
+    for (int i = 0; i < RENDER_SLOTS; i++) {
+        s->render_slots[i] = (uint8_t*)heap_caps_calloc(1, bytes, MALLOC_CAP_8BIT);
+        if (s->render_slots[i] == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate %u byte render slots", (unsigned)bytes);
+            freeRender(s);
+            return NEOLED_ERR_NO_MEM;
+        }
+    }
+
+    s->render_back = 0;
+    s->render_middle.store(1, std::memory_order_relaxed);
+    s->render_front = 2;
+    s->render_stop.store(false, std::memory_order_relaxed);
+    s->render_dropped.store(0, std::memory_order_relaxed);
+
+    s->render_wake = xSemaphoreCreateBinary();
+    s->render_exit = xSemaphoreCreateBinary();
+    if (s->render_wake == NULL || s->render_exit == NULL) {
+        freeRender(s);
+        return NEOLED_ERR_NO_MEM;
+    }
+
+    char name[16];
+    snprintf(name, sizeof(name), "neoled_rd%d", s->port);
+
+    if (xTaskCreatePinnedToCore(renderTask, name, NEOLED_TASK_STACK_SIZE, s,
+                                NEOLED_TASK_PRIORITY, NULL, core) != pdPASS) {
+        freeRender(s);
+        return NEOLED_ERR_NO_MEM;
+    }
+
+    s->render_running = true;
+    return NEOLED_OK;
+}
+#endif
+
+// ============================================================================
+// Strip Implementation
+// ============================================================================
+
+Strip::Strip(uint16_t led_count)
+    : state(new (std::nothrow) StripState())
+{
+    if (state == nullptr) {
+        ESP_LOGE(TAG, "Failed to allocate strip state");
+        return;
+    }
+
+    state->led_count = led_count;
+    state->gpio_pin = I2S_DO_IO;
+    state->port = I2S_NUM;
+    state->backend = &i2s_backend;
+    state->protocol = NEOLED_WS2812;
+    state->protocol_info = lookupProtocol(NEOLED_WS2812);
+    state->color_order = NEOLED_ORDER_DEFAULT;
+    applyFrameFormat(state);
+    state->brightness = 255;
+    state->gamma = 1.0f;
+    state->curve_gamma = 1.0f;
+    state->channel_ma = NEOLED_CHANNEL_MA;
+    for (int channel = 0; channel < 4; channel++) {
+        state->correction_scale[channel] = 255;
+    }
+}
+
+Strip::~Strip()
+{
+    if (state == nullptr) {
+        return;
+    }
+
+    destroy();
+    freeBuffers(state);
+    heap_caps_free(state->correction_tables);
+    heap_caps_free(state->framebuffer);
+    delete state;
+}
+
+neoled_err_t Strip::init(void)
+{
+    return initWithPin(I2S_DO_IO);
+}
+
+neoled_err_t Strip::initWithPin(int gpio_pin)
+{
+    return initWithPin(gpio_pin, I2S_NUM);
+}
+
+neoled_err_t Strip::initWithPin(int gpio_pin, int port)
+{
+    if (state == nullptr) {
+        return NEOLED_ERR_NO_MEM;
+    }
+
+    StripState* s = state;
+    if (s->initialized) {
+        ESP_LOGW(TAG, "Already initialized, call destroy() first");
+        return NEOLED_OK;  // Already initialized is not an error
+    }
+
+    if (s->led_count == 0) {
+        ESP_LOGE(TAG, "LED count must be at least 1");
+        return NEOLED_ERR_PARAM;
+    }
+
+    if (s->stream_leds != 0 && s->backend->format == NEOLED_FRAME_GRB) {
+        ESP_LOGE(TAG, "Streaming needs a backend that sends the reset as part of the frame");
+        return NEOLED_ERR_PARAM;
+    }
+#if NEOLED_DITHER
+    if (s->stream_leds != 0 && s->dithering) {
+        ESP_LOGE(TAG, "Dithering needs whole-frame buffers, not available while streaming");
+        return NEOLED_ERR_PARAM;
+    }
+#endif
+
+    neoled_err_t err = allocateBuffers(s);
+    if (err != NEOLED_OK) {
+        return err;
+    }
+#if NEOLED_DITHER
+    if (s->dithering) {
+        err = allocateDitherPixels(s);
+        if (err != NEOLED_OK) {
+            return err;
+        }
+    }
+#endif
+
+    s->gpio_pin = gpio_pin;
+    s->port = port;
+    computeDmaLayout(s);
+
+    // A streaming strip writes at most one chunk and the reset at a time
+    size_t write_bytes = s->frame_bytes;
+    if (s->stream_leds != 0) {
+        write_bytes = (size_t)chunkLeds(s) * s->pixel_bytes + s->reset_bytes;
+        s->stream_slack_us = streamSlack(s);
+        s->stream_encode_us = 0;
+        s->stream_underruns = 0;
+    }
+
+    const ProtocolInfo* protocol = s->protocol_info;
+    neoled_backend_config_t config = {
+        port, gpio_pin, protocol->sample_rate, s->dma_desc_num, s->dma_frame_num, write_bytes,
+        protocol->t0h_ns, protocol->t1h_ns, protocol->bit_ns, protocol->reset_us, protocol->spi_clock_hz
+    };
+    err = s->backend->init(&config, &s->backend_handle);
+    if (err != NEOLED_OK) {
+        return err;
+    }
+
+#if NEOLED_ASYNC
+    if (startWriter(s) != NEOLED_OK) {
+        ESP_LOGE(TAG, "Failed to start writer task");
+        deinitBackend(s);
+        return NEOLED_ERR_NO_MEM;
+    }
+#endif
+
+    s->initialized = true;
+
+    ESP_LOGI(TAG, "Initialized %s port %d with GPIO %d, %u LEDs", s->backend->name, port, gpio_pin, s->led_count);
+
+    // Clear LEDs on init
+    clear();
+
+    return NEOLED_OK;
+}
+
+neoled_err_t Strip::update(const Pixel* pixels)
+{
+    return updateWithBrightness(pixels, state != nullptr ? state->brightness : 255);
+}
+
+neoled_err_t Strip::updateWithBrightness(const Pixel* pixels, uint8_t brightness)
+{
+    neoled_err_t err = checkUpdate(state, pixels, false);
+    if (err != NEOLED_OK) {
+        return err;
+    }
+
+    return showPixels(state, pixels, state->led_count, brightness);
+}
+
+neoled_err_t Strip::update(const PixelW* pixels)
+{
+    return updateWithBrightness(pixels, state != nullptr ? state->brightness : 255);
+}
+
+neoled_err_t Strip::updateWithBrightness(const PixelW* pixels, uint8_t brightness)
+{
+    neoled_err_t err = checkUpdate(state, pixels, true);
+    if (err != NEOLED_OK) {
+        return err;
+    }
+
+    return showPixels(state, pixels, state->led_count, brightness);
+}
+
+#if NEOLED_PIXEL16
+neoled_err_t Strip::update(const Pixel16* pixels)
+{
+    return updateWithBrightness(pixels, state != nullptr ? state->brightness : 255);
+}
+
+neoled_err_t Strip::updateWithBrightness(const Pixel16* pixels, uint8_t brightness)
+{
+    neoled_err_t err = checkUpdate(state, pixels, false);
+    if (err != NEOLED_OK) {
+        return err;
+    }
+
+    return showPixels(state, pixels, state->led_count, brightness);
+}
+#endif
+
+neoled_err_t Strip::updateRange(const Pixel* pixels, uint16_t count)
+{
+    if (!isInitialized()) {
+        ESP_LOGE(TAG, "Not initialized");
+        return NEOLED_ERR_NOT_INIT;
+    }
+
+    if (pixels == nullptr || count == 0 || count > state->led_count) {
+        ESP_LOGE(TAG, "Invalid pixel range (count %u)", count);
+        return NEOLED_ERR_PARAM;
+    }
+    if (renderOwned(state)) {
+        return NEOLED_ERR_PARAM;
+    }
+
+    return showPixels(state, pixels, count, state->brightness);
+}
+
+#if NEOLED_ASYNC
+/**
+ * @brief Encode pixels into the free buffer and queue them for the writer task
+ * @tparam P Pixel, PixelW or Pixel16
+ * @param s Strip state
+ * @param pixels Source pixel array (led_count pixels)
+ * @return NEOLED_OK on success, NEOLED_ERR_PARAM while streaming, error code
+ *         otherwise
+ */
+template <typename P>
+static neoled_err_t queuePixels(StripState* s, const P* pixels)
+{
+    if (s->stream_leds != 0) {
+        ESP_LOGE(TAG, "updateAsync() needs frame buffers, use update() while streaming");
+        return NEOLED_ERR_PARAM;
+    }
+    if (s->encoded_framebuffer) {
+        // setPixel() would write into a buffer the writer task may be sending
+        ESP_LOGE(TAG, "updateAsync() is not available in encoded framebuffer mode");
+        return NEOLED_ERR_PARAM;
+    }
+
+    // Encode into the buffer that is not holding the previous frame; this only
+    // waits if that buffer's earlier frame is still queued or on the wire
+    int buffer = (s->active_buffer + 1) % NEOLED_BUFFER_COUNT;
+    xSemaphoreTake(s->buffer_free[buffer], portMAX_DELAY);
+
+    uint16_t dirty_end = encodePixels(s, buffer, pixels, s->led_count, s->brightness);
+    s->active_buffer = buffer;
+
+    FrameJob job = {(uint8_t)buffer, s->auto_prefix ? dirty_end : s->led_count};
+    if (xQueueSend(s->frame_queue, &job, portMAX_DELAY) != pdTRUE) {
+        xSemaphoreGive(s->buffer_free[buffer]);
+        return NEOLED_ERR_I2S;
+    }
+
+    return NEOLED_OK;
+}
+
+neoled_err_t Strip::updateAsync(const Pixel* pixels)
+{
+    neoled_err_t err = checkUpdate(state, pixels, false);
+    if (err != NEOLED_OK) {
+        return err;
+    }
+
+    return queuePixels(state, pixels);
+}
+
+neoled_err_t Strip::updateAsync(const PixelW* pixels)
+{
+    neoled_err_t err = checkUpdate(state, pixels, true);
+    if (err != NEOLED_OK) {
+        return err;
+    }
+
+    return queuePixels(state, pixels);
+}
+
+#if NEOLED_PIXEL16
+neoled_err_t Strip::updateAsync(const Pixel16* pixels)
+{
+    neoled_err_t err = checkUpdate(state, pixels, false);
+    if (err != NEOLED_OK) {
+        return err;
+    }
+
+    return queuePixels(state, pixels);
+}
+#endif
+
+neoled_err_t Strip::waitForUpdate(uint32_t timeout_ms)
+{
+    if (!isInitialized()) {
+        return NEOLED_ERR_NOT_INIT;
+    }
+
+    TickType_t timeout = (timeout_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    if (!claimBuffers(state, timeout)) {
+        return NEOLED_ERR_TIMEOUT;
+    }
+    releaseBuffers(state);
+
+    return NEOLED_OK;
+}
+
+void Strip::setUpdateCallback(neoled_update_cb_t callback, void* user_data)
+{
+    if (state != nullptr) {
+        state->update_callback = callback;
+        state->update_callback_arg = user_data;
+    }
+}
+#endif
+
+// ============================================================================
+// Library-owned framebuffer
+// ============================================================================
+
+/**
+ * @brief Record that a framebuffer LED changed since each buffer was encoded
+ * @param s Strip state
+ * @param index LED that was written
+ */
+static inline void markFramebuffer(StripState* s, uint16_t index)
+{
+#if NEOLED_DIRTY_TRACKING
+    for (int b = 0; b < NEOLED_BUFFER_COUNT; b++) {
+        if (s->framebuffer_dirty_end[b] <= index) {
+            s->framebuffer_dirty_end[b] = index + 1;
+        }
+    }
+#else
+    (void)s;
+    (void)index;
+#endif
+}
+
+/**
+ * @brief Allocate the framebuffer and hand it out for direct writes
+ * @param s Strip state
+ * @param rgbw true for a PixelW view, false for a Pixel view
+ * @return Framebuffer, NULL if the layout does not match the protocol or
+ *         allocation failed
+ */
+static uint8_t* shareFramebuffer(StripState* s, bool rgbw)
+{
+    if (s == nullptr) {
+        return NULL;
+    }
+    if (rgbw != (s->protocol_info->channels == 4)) {
+        ESP_LOGE(TAG, "%s framebuffer does not match the protocol", rgbw ? "RGBW" : "RGB");
+        return NULL;
+    }
+    if (s->encoded_framebuffer) {
+        ESP_LOGE(TAG, "No pixel framebuffer in encoded framebuffer mode");
+        return NULL;
+    }
+    if (allocateFramebuffer(s) != NEOLED_OK) {
+        return NULL;
+    }
+
+    // Writes through the pointer are not seen, so show() compares every pixel
+    s->framebuffer_shared = true;
+    return s->framebuffer;
+}
+
+/**
+ * @brief Run the strip's in-place encoder for a pixel type
+ */
+static inline void encodeAt(StripState* s, int buffer, uint16_t index, const Pixel& pixel)
+{
+    s->encode_pixel(s, buffer, index, pixel);
+}
+
+static inline void encodeAt(StripState* s, int buffer, uint16_t index, const PixelW& pixel)
+{
+    s->encode_pixel_w(s, buffer, index, pixel);
+}
+
+/**
+ * @brief Encode one LED straight into the active buffer (encoded framebuffer mode)
+ * @tparam P Pixel or PixelW
+ * @param s Strip state
+ * @param index LED index, already range checked
+ * @param pixel New colour of the LED
+ * @return NEOLED_OK on success, NEOLED_ERR_NOT_INIT without frame buffers
+ */
+template <typename P>
+static neoled_err_t setEncodedPixel(StripState* s, uint16_t index, const P& pixel)
+{
+    if (!s->initialized) {
+        ESP_LOGE(TAG, "Not initialized");
+        return NEOLED_ERR_NOT_INIT;
+    }
+    if (renderOwned(s)) {
+        return NEOLED_ERR_PARAM;
+    }
+
+    // Only synchronous frames are sent in this mode, and backends are done
+    // with the buffer when write() returns, so it is never on the wire here.
+    // The table is only rebuilt if brightness or gamma changed.
+    preparePipeline(s, s->brightness);
+    encodeAt(s, s->active_buffer, index, pixel);
+
+    if (s->encoded_dirty_end <= index) {
+        s->encoded_dirty_end = index + 1;
+    }
+#if NEOLED_DIRTY_TRACKING
+    s->framebuffer_dirty_end[s->active_buffer] = s->led_count;
+#endif
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Send the active buffer as it stands (encoded framebuffer mode)
+ * @param s Strip state
+ * @return NEOLED_OK on success, error code otherwise
+ */
+static neoled_err_t showEncoded(StripState* s)
+{
+#if NEOLED_ASYNC
+    claimBuffers(s, portMAX_DELAY);
+#endif
+
+    uint16_t send_count = s->auto_prefix ? s->encoded_dirty_end : s->led_count;
+    neoled_err_t ret = transmit(s, s->out_buffers[s->active_buffer], send_count);
+    s->encoded_dirty_end = 0;
+#if NEOLED_DIRTY_TRACKING
+    if (s->shown_valid[s->active_buffer]) {
+        s->frame_current_ma = frameCurrent(s, s->pipeline_brightness);
+    }
+#endif
+
+#if NEOLED_ASYNC
+    releaseBuffers(s);
+#endif
+
+    return ret;
+}
+
+Pixel* Strip::getPixels(void)
+{
+    return reinterpret_cast<Pixel*>(shareFramebuffer(state, false));
+}
+
+PixelW* Strip::getPixelsW(void)
+{
+    return reinterpret_cast<PixelW*>(shareFramebuffer(state, true));
+}
+
+neoled_err_t Strip::setPixel(uint16_t index, const Pixel& pixel)
+{
+    if (state == nullptr) {
+        return NEOLED_ERR_NO_MEM;
+    }
+    if (index >= state->led_count) {
+        return NEOLED_ERR_PARAM;
+    }
+    if (state->encoded_framebuffer) {
+        return setEncodedPixel(state, index, pixel);
+    }
+
+    neoled_err_t err = allocateFramebuffer(state);
+    if (err != NEOLED_OK) {
+        return err;
+    }
+
+    if (state->protocol_info->channels == 4) {
+        PixelW* pixels = reinterpret_cast<PixelW*>(state->framebuffer);
+        pixels[index].green = pixel.green;
+        pixels[index].red = pixel.red;
+        pixels[index].blue = pixel.blue;
+        pixels[index].white = 0;
+    } else {
+        reinterpret_cast<Pixel*>(state->framebuffer)[index] = pixel;
+    }
+    markFramebuffer(state, index);
+    return NEOLED_OK;
+}
+
+neoled_err_t Strip::setPixel(uint16_t index, const PixelW& pixel)
+{
+    if (state == nullptr) {
+        return NEOLED_ERR_NO_MEM;
+    }
+    if (index >= state->led_count || state->protocol_info->channels != 4) {
+        return NEOLED_ERR_PARAM;
+    }
+    if (state->encoded_framebuffer) {
+        return setEncodedPixel(state, index, pixel);
+    }
+
+    neoled_err_t err = allocateFramebuffer(state);
+    if (err != NEOLED_OK) {
+        return err;
+    }
+
+    reinterpret_cast<PixelW*>(state->framebuffer)[index] = pixel;
+    markFramebuffer(state, index);
+    return NEOLED_OK;
+}
+
+neoled_err_t Strip::show(void)
+{
+    if (!isInitialized()) {
+        ESP_LOGE(TAG, "Not initialized");
+        return NEOLED_ERR_NOT_INIT;
+    }
+    if (renderOwned(state)) {
+        return NEOLED_ERR_PARAM;
+    }
+    if (state->encoded_framebuffer) {
+        return showEncoded(state);
+    }
+    neoled_err_t err = allocateFramebuffer(state);
+    if (err != NEOLED_OK) {
+        return err;
+    }
+
+    if (state->protocol_info->channels == 4) {
+        return showPixels(state, reinterpret_cast<const PixelW*>(state->framebuffer), state->led_count,
+                          state->brightness);
+    }
+    return showPixels(state, reinterpret_cast<const Pixel*>(state->framebuffer), state->led_count,
+                      state->brightness);
+}
+
+#if NEOLED_ASYNC
+neoled_err_t Strip::showAsync(void)
+{
+    if (!isInitialized()) {
+        ESP_LOGE(TAG, "Not initialized");
+        return NEOLED_ERR_NOT_INIT;
+    }
+    if (renderOwned(state)) {
+        return NEOLED_ERR_PARAM;
+    }
+    if (state->encoded_framebuffer) {
+        ESP_LOGE(TAG, "showAsync() is not available in encoded framebuffer mode, use show()");
+        return NEOLED_ERR_PARAM;
+    }
+    neoled_err_t err = allocateFramebuffer(state);
+    if (err != NEOLED_OK) {
+        return err;
+    }
+
+    // The framebuffer is encoded before this returns, so it may be written
+    // again straight away
+    if (state->protocol_info->channels == 4) {
+        return queuePixels(state, reinterpret_cast<const PixelW*>(state->framebuffer));
+    }
+    return queuePixels(state, reinterpret_cast<const Pixel*>(state->framebuffer));
+}
+#endif
+
+neoled_err_t Strip::fill(const Pixel& colour)
+{
+    if (!isInitialized()) {
+        return NEOLED_ERR_NOT_INIT;
+    }
+    if (renderOwned(state)) {
+        return NEOLED_ERR_PARAM;
+    }
+
+    return showSolid(state, colour, state->brightness);
+}
+
+neoled_err_t Strip::clear(void)
+{
+    if (!isInitialized()) {
+        return NEOLED_ERR_NOT_INIT;
+    }
+    if (renderOwned(state)) {
+        return NEOLED_ERR_PARAM;
+    }
+
+    // Off encodes the same at any brightness; the strip's keeps the
+    // pipeline tables, and the dirty tracking baseline, for the next update
+    return showSolid(state, COLOR_OFF, state->brightness);
+}
+
+neoled_err_t Strip::destroy(void)
+{
+    if (!isInitialized()) {
+        return NEOLED_OK;  // Not an error to destroy when not initialized
+    }
+
+    StripState* s = state;
+#if NEOLED_RENDER
+    stopRenderTask(s);
+#endif
+
+    // Turn off LEDs before destroying
+    clear();
+
+#if NEOLED_ASYNC
+    stopWriter(s);
+#endif
+    deinitBackend(s);
+
+#if NEOLED_DIRTY_TRACKING
+    for (int b = 0; b < NEOLED_BUFFER_COUNT; b++) {
+        s->shown_valid[b] = false;
+    }
+#endif
+    s->skipped_pixels = 0;
+    s->initialized = false;
+    ESP_LOGI(TAG, "Destroyed");
+
+    return NEOLED_OK;
+}
+
+neoled_err_t Strip::setBackend(const neoled_backend_t* backend)
+{
+    if (state == nullptr) {
+        return NEOLED_ERR_NO_MEM;
+    }
+    if (backend == nullptr) {
+        return NEOLED_ERR_PARAM;
+    }
+    if (state->initialized) {
+        ESP_LOGE(TAG, "Cannot change backend while initialized");
+        return NEOLED_ERR_INIT;
+    }
+
+    state->backend = backend;
+    applyFrameFormat(state);
+    return NEOLED_OK;
+}
+
+const neoled_backend_t* Strip::getBackend(void) const
+{
+    return state != nullptr ? state->backend : &i2s_backend;
+}
+
+neoled_err_t Strip::setProtocol(neoled_protocol_t protocol)
+{
+    if (state == nullptr) {
+        return NEOLED_ERR_NO_MEM;
+    }
+
+    const ProtocolInfo* info = lookupProtocol(protocol);
+    if (info == NULL) {
+        return NEOLED_ERR_PARAM;
+    }
+    if (state->initialized) {
+        ESP_LOGE(TAG, "Cannot change protocol while initialized");
+        return NEOLED_ERR_INIT;
+    }
+
+    if (state->framebuffer != NULL && info->channels != state->protocol_info->channels) {
+        // Reallocated with the new pixel size on next use
+        heap_caps_free(state->framebuffer);
+        state->framebuffer = NULL;
+    }
+
+    state->protocol = protocol;
+    state->protocol_info = info;
+    applyFrameFormat(state);
+    return NEOLED_OK;
+}
+
+neoled_protocol_t Strip::getProtocol(void) const
+{
+    return state != nullptr ? state->protocol : NEOLED_WS2812;
+}
+
+neoled_err_t Strip::setColorOrder(neoled_color_order_t order)
+{
+    if (state == nullptr) {
+        return NEOLED_ERR_NO_MEM;
+    }
+#if NEOLED_COLOR_ORDERS
+    if (order < NEOLED_ORDER_DEFAULT || order > NEOLED_ORDER_BGR) {
+        return NEOLED_ERR_PARAM;
+    }
+#else
+    if (order != NEOLED_ORDER_DEFAULT && order != NEOLED_ORDER_GRB && order != NEOLED_ORDER_RGB) {
+        ESP_LOGE(TAG, "Colour order %d needs NEOLED_COLOR_ORDERS", order);
+        return NEOLED_ERR_PARAM;
+    }
+#endif
+    if (state->initialized) {
+        ESP_LOGE(TAG, "Cannot change colour order while initialized");
+        return NEOLED_ERR_INIT;
+    }
+
+    state->color_order = order;
+    applyFrameFormat(state);
+    return NEOLED_OK;
+}
+
+neoled_color_order_t Strip::getColorOrder(void) const
+{
+    if (state == nullptr) {
+        return NEOLED_ORDER_GRB;
+    }
+    return state->color_order != NEOLED_ORDER_DEFAULT ? state->color_order : state->protocol_info->order;
+}
+
+bool Strip::isInitialized(void) const
+{
+    return state != nullptr && state->initialized;
+}
+
+uint16_t Strip::getLedCount(void) const
+{
+    return state != nullptr ? state->led_count : 0;
+}
+
+void Strip::setBrightness(uint8_t brightness)
+{
+    if (state != nullptr && !renderSettingsLocked(state) && !encodedSettingsLocked(state)) {
+        state->brightness = brightness;
+    }
+}
+
+uint8_t Strip::getBrightness(void) const
+{
+    return state != nullptr ? state->brightness : 0;
+}
+
+void Strip::setGamma(float gamma)
+{
+    if (state != nullptr && !renderSettingsLocked(state) && !encodedSettingsLocked(state)) {
+        state->gamma = gamma;
+    }
+}
+
+float Strip::getGamma(void) const
+{
+    return state != nullptr ? state->gamma : 1.0f;
+}
+
+void Strip::setAutoPrefix(bool enable)
+{
+    if (state != nullptr && !renderSettingsLocked(state)) {
+        state->auto_prefix = enable;
+    }
+}
+
+bool Strip::getAutoPrefix(void) const
+{
+    return state != nullptr && state->auto_prefix;
+}
+
+void Strip::setPowerLimit(uint16_t channel_ma, uint32_t limit_ma)
+{
+    if (state == nullptr || renderSettingsLocked(state)) {
+        return;
+    }
+    // Encoded LEDs are not re-encoded, so a limit could not be held
+    if (limit_ma != 0 && encodedSettingsLocked(state)) {
+        return;
+    }
+    state->channel_ma = channel_ma;
+    state->power_limit_ma = limit_ma;
+}
+
+uint32_t Strip::getPowerLimit(void) const
+{
+    return state != nullptr ? state->power_limit_ma : 0;
+}
+
+uint32_t Strip::getEstimatedCurrent(void) const
+{
+    return state != nullptr ? state->frame_current_ma : 0;
+}
+
+neoled_err_t Strip::setColorCorrection(const neoled_color_correction_t* correction)
+{
+    if (state == nullptr) {
+        return NEOLED_ERR_NO_MEM;
+    }
+
+    neoled_color_correction_t none = {255, 255, 255, 255, 0.0f, 0.0f, 0.0f, 0.0f};
+    if (correction == NULL) {
+        correction = &none;
+    }
+    if (correction->gamma_red < 0.0f || correction->gamma_green < 0.0f ||
+        correction->gamma_blue < 0.0f || correction->gamma_white < 0.0f) {
+        return NEOLED_ERR_PARAM;
+    }
+    // The render task may be encoding with the tables this frees
+    if (renderSettingsLocked(state) || encodedSettingsLocked(state)) {
+        return NEOLED_ERR_PARAM;
+    }
+
+    bool identity = correction->red == 255 && correction->green == 255 && correction->blue == 255 &&
+                    correction->white == 255 && correction->gamma_red == 0.0f &&
+                    correction->gamma_green == 0.0f && correction->gamma_blue == 0.0f &&
+                    correction->gamma_white == 0.0f;
+    if (identity) {
+        heap_caps_free(state->correction_tables);
+        state->correction_tables = NULL;
+    } else if (state->correction_tables == NULL) {
+        state->correction_tables = (CorrectionTables*)heap_caps_malloc(sizeof(CorrectionTables), MALLOC_CAP_8BIT);
+        if (state->correction_tables == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate colour correction tables");
+            return NEOLED_ERR_NO_MEM;
+        }
+    }
+
+    state->correction_scale[CHANNEL_RED] = correction->red;
+    state->correction_scale[CHANNEL_GREEN] = correction->green;
+    state->correction_scale[CHANNEL_BLUE] = correction->blue;
+    state->correction_scale[CHANNEL_WHITE] = correction->white;
+    state->correction_gamma[CHANNEL_RED] = correction->gamma_red;
+    state->correction_gamma[CHANNEL_GREEN] = correction->gamma_green;
+    state->correction_gamma[CHANNEL_BLUE] = correction->gamma_blue;
+    state->correction_gamma[CHANNEL_WHITE] = correction->gamma_white;
+    state->curve_valid = false;
+    return NEOLED_OK;
+}
+
+void Strip::getColorCorrection(neoled_color_correction_t* correction) const
+{
+    if (correction == NULL) {
+        return;
+    }
+
+    correction->red = state != nullptr ? state->correction_scale[CHANNEL_RED] : 255;
+    correction->green = state != nullptr ? state->correction_scale[CHANNEL_GREEN] : 255;
+    correction->blue = state != nullptr ? state->correction_scale[CHANNEL_BLUE] : 255;
+    correction->white = state != nullptr ? state->correction_scale[CHANNEL_WHITE] : 255;
+    correction->gamma_red = state != nullptr ? state->correction_gamma[CHANNEL_RED] : 0.0f;
+    correction->gamma_green = state != nullptr ? state->correction_gamma[CHANNEL_GREEN] : 0.0f;
+    correction->gamma_blue = state != nullptr ? state->correction_gamma[CHANNEL_BLUE] : 0.0f;
+    correction->gamma_white = state != nullptr ? state->correction_gamma[CHANNEL_WHITE] : 0.0f;
+}
+
+neoled_err_t Strip::setStreaming(uint16_t chunk_leds)
+{
+    if (state == nullptr) {
+        return NEOLED_ERR_NO_MEM;
+    }
+    if (state->initialized) {
+        ESP_LOGE(TAG, "Cannot change streaming while initialized");
+        return NEOLED_ERR_INIT;
+    }
+
+    if (chunk_leds != 0 && state->encoded_framebuffer) {
+        ESP_LOGE(TAG, "Streaming keeps no frame buffer to encode into, leave encoded framebuffer mode first");
+        return NEOLED_ERR_PARAM;
+    }
+
+    if (chunk_leds != state->stream_leds) {
+        // Frame and chunk buffers are sized differently; reallocated at init
+        freeBuffers(state);
+        state->stream_leds = chunk_leds;
+    }
+    return NEOLED_OK;
+}
+
+uint16_t Strip::getStreaming(void) const
+{
+    return state != nullptr ? state->stream_leds : 0;
+}
+
+void Strip::getStreamStats(neoled_stream_stats_t* stats) const
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->encode_us = state != nullptr ? state->stream_encode_us : 0;
+    stats->slack_us = state != nullptr ? state->stream_slack_us : 0;
+    stats->underruns = state != nullptr ? state->stream_underruns : 0;
+}
+
+neoled_err_t Strip::setEncodedFramebuffer(bool enable)
+{
+    if (state == nullptr) {
+        return NEOLED_ERR_NO_MEM;
+    }
+
+    if (enable && state->stream_leds != 0) {
+        ESP_LOGE(TAG, "Encoded framebuffer mode needs whole-frame buffers, not available while streaming");
+        return NEOLED_ERR_PARAM;
+    }
+#if NEOLED_DITHER
+    if (enable && state->dithering) {
+        ESP_LOGE(TAG, "Encoded framebuffer mode is not available while dithering");
+        return NEOLED_ERR_PARAM;
+    }
+#endif
+    if (enable && state->power_limit_ma != 0) {
+        ESP_LOGE(TAG, "Encoded framebuffer mode does not apply the power limit, set it to 0 first");
+        return NEOLED_ERR_PARAM;
+    }
+    if (enable && renderOwned(state)) {
+        return NEOLED_ERR_PARAM;
+    }
+
+#if NEOLED_ASYNC
+    // From here on setPixel() writes into the active buffer, so no queued
+    // frame may still be reading it
+    if (enable && state->initialized) {
+        claimBuffers(state, portMAX_DELAY);
+        releaseBuffers(state);
+    }
+#endif
+
+    state->encoded_framebuffer = enable;
+    state->encoded_dirty_end = 0;
+    return NEOLED_OK;
+}
+
+bool Strip::getEncodedFramebuffer(void) const
+{
+    return state != nullptr && state->encoded_framebuffer;
+}
+
+#if NEOLED_RENDER
+neoled_err_t Strip::startRender(int core)
+{
+    if (!isInitialized()) {
+        ESP_LOGE(TAG, "Not initialized");
+        return NEOLED_ERR_NOT_INIT;
+    }
+    if (state->render_running) {
+        ESP_LOGE(TAG, "Render task already running");
+        return NEOLED_ERR_INIT;
+    }
+    if (state->encoded_framebuffer) {
+        ESP_LOGE(TAG, "The render task sends pixel frames, not available in encoded framebuffer mode");
+        return NEOLED_ERR_PARAM;
+    }
+
+#if NEOLED_ASYNC
+    // The task sends synchronously; let frames already queued go out first
+    claimBuffers(state, portMAX_DELAY);
+    releaseBuffers(state);
+#endif
+
+    return startRenderTask(state, core);
+}
+
+neoled_err_t Strip::stopRender(void)
+{
+    if (state != nullptr) {
+        stopRenderTask(state);
+    }
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Producer's render slot, if the task runs and the layout matches
+ * @param s Strip state (may be NULL)
+ * @param rgbw true for a PixelW view, false for a Pixel view
+ * @return Slot to draw the next frame into, NULL otherwise
+ */
+static uint8_t* renderSlot(const StripState* s, bool rgbw)
+{
+    if (s == nullptr || !s->render_running) {
+        return NULL;
+    }
+    if (rgbw != (s->protocol_info->channels == 4)) {
+        ESP_LOGE(TAG, "%s frame does not match the protocol", rgbw ? "RGBW" : "RGB");
+        return NULL;
+    }
+    return s->render_slots[s->render_back];
+}
+
+Pixel* Strip::acquireFrame(void)
+{
+    return reinterpret_cast<Pixel*>(renderSlot(state, false));
+}
+
+PixelW* Strip::acquireFrameW(void)
+{
+    return reinterpret_cast<PixelW*>(renderSlot(state, true));
+}
+
+neoled_err_t Strip::submitFrame(void)
+{
+    if (state == nullptr || !state->render_running) {
+        ESP_LOGE(TAG, "Render task not running");
+        return NEOLED_ERR_NOT_INIT;
+    }
+
+    // Publish the drawn slot and take back whichever slot was waiting. If the
+    // task had not taken that one yet, it is dropped: only the newest counts.
+    uint8_t previous = state->render_middle.exchange(state->render_back | RENDER_FRESH, std::memory_order_acq_rel);
+    state->render_back = previous & RENDER_SLOT_MASK;
+    if (previous & RENDER_FRESH) {
+        state->render_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // A binary semaphore: wake-ups while the task is busy merge into one
+    xSemaphoreGive(state->render_wake);
+    return NEOLED_OK;
+}
+
+uint32_t Strip::getDroppedFrames(void) const
+{
+    return state != nullptr ? state->render_dropped.load(std::memory_order_relaxed) : 0;
+}
+#endif
+
+#if NEOLED_DITHER
+neoled_err_t Strip::setDithering(bool enable)
+{
+    if (state == nullptr) {
+        return NEOLED_ERR_NO_MEM;
+    }
+
+    if (enable && state->initialized && state->stream_leds != 0) {
+        ESP_LOGE(TAG, "Dithering needs whole-frame buffers, not available while streaming");
+        return NEOLED_ERR_PARAM;
+    }
+    if (enable && state->encoded_framebuffer) {
+        ESP_LOGE(TAG, "Dithering re-encodes every frame, not available in encoded framebuffer mode");
+        return NEOLED_ERR_PARAM;
+    }
+    if (renderSettingsLocked(state)) {
+        return NEOLED_ERR_PARAM;
+    }
+
+    // Before init the pixel copy is allocated with the frame buffers
+    if (enable && state->initialized) {
+        neoled_err_t err = allocateDitherPixels(state);
+        if (err != NEOLED_OK) {
+            return err;
+        }
+    }
+
+    // Carry the frame on the LEDs across, so refresh() after enabling shows
+    // the same picture rather than an all-off source
+    if (state->initialized && enable != state->dithering) {
+        bool rgbw = state->protocol_info->channels == 4;
+        if (enable) {
+            state->dither_seeded = rgbw ? handOverDitherSource<PixelW>(state, true)
+                                        : handOverDitherSource<Pixel>(state, true);
+        } else if (state->dither_seeded && rgbw) {
+            handOverDitherSource<PixelW>(state, false);
+        } else if (state->dither_seeded) {
+            handOverDitherSource<Pixel>(state, false);
+        }
+    }
+
+    state->dithering = enable;
+    return NEOLED_OK;
+}
+
+bool Strip::getDithering(void) const
+{
+    return state != nullptr && state->dithering;
+}
+
+neoled_err_t Strip::refresh(void)
+{
+    if (!isInitialized()) {
+        ESP_LOGE(TAG, "Not initialized");
+        return NEOLED_ERR_NOT_INIT;
+    }
+    if (!state->dithering) {
+        ESP_LOGE(TAG, "Dithering is off");
+        return NEOLED_ERR_PARAM;
+    }
+    if (!state->dither_seeded) {
+        ESP_LOGE(TAG, "No frame sent since dithering was enabled");
+        return NEOLED_ERR_PARAM;
+    }
+    if (renderOwned(state)) {
+        return NEOLED_ERR_PARAM;
+    }
+
+    return showPixels(state, (const Pixel*)NULL, state->led_count, state->pipeline_brightness);
+}
+
+#if NEOLED_RENDER
+neoled_err_t Strip::setDitherRefresh(uint16_t interval_ms)
+{
+    if (state == nullptr) {
+        return NEOLED_ERR_NO_MEM;
+    }
+    if (renderSettingsLocked(state)) {
+        return NEOLED_ERR_PARAM;
+    }
+
+    state->dither_refresh_ms = interval_ms;
+    return NEOLED_OK;
+}
+
+uint16_t Strip::getDitherRefresh(void) const
+{
+    return state != nullptr ? state->dither_refresh_ms : 0;
+}
+#endif
+#endif
+
+neoled_err_t Strip::getDmaInfo(neoled_dma_info_t* info) const
+{
+    if (info == nullptr) {
+        return NEOLED_ERR_PARAM;
+    }
+    if (!isInitialized()) {
+        return NEOLED_ERR_NOT_INIT;
+    }
+
+    info->desc_num = state->dma_desc_num;
+    info->desc_bytes = state->dma_frame_num * I2S_SAMPLE_BYTES;
+    info->total_bytes = (size_t)state->dma_desc_num * state->dma_frame_num * I2S_SAMPLE_BYTES;
+    return NEOLED_OK;
+}
+
+uint16_t Strip::getSkippedPixels(void) const
+{
+    return state != nullptr ? state->skipped_pixels : 0;
+}
+
+// ============================================================================
+// Core Functions Implementation (default strip)
+// ============================================================================
+
+Strip& defaultStrip(void)
+{
+    static Strip strip(LED_NUMBER);
+    return strip;
+}
+
+neoled_err_t init(void)
+{
+    return defaultStrip().init();
+}
+
+neoled_err_t initWithPin(int gpio_pin)
+{
+    return defaultStrip().initWithPin(gpio_pin);
+}
+
+neoled_err_t initWithPin(int gpio_pin, int port)
+{
+    return defaultStrip().initWithPin(gpio_pin, port);
+}
+
+neoled_err_t setBackend(const neoled_backend_t* backend)
+{
+    return defaultStrip().setBackend(backend);
+}
+
+const neoled_backend_t* getBackend(void)
+{
+    return defaultStrip().getBackend();
+}
+
+neoled_err_t setProtocol(neoled_protocol_t protocol)
+{
+    return defaultStrip().setProtocol(protocol);
+}
+
+neoled_protocol_t getProtocol(void)
+{
+    return defaultStrip().getProtocol();
+}
+
+neoled_err_t setColorOrder(neoled_color_order_t order)
+{
+    return defaultStrip().setColorOrder(order);
+}
+
+neoled_color_order_t getColorOrder(void)
+{
+    return defaultStrip().getColorOrder();
+}
+
+neoled_err_t update(const Pixel* pixels)
+{
+    return defaultStrip().update(pixels);
+}
+
+neoled_err_t updateWithBrightness(const Pixel* pixels, uint8_t brightness)
+{
+    return defaultStrip().updateWithBrightness(pixels, brightness);
+}
+
+neoled_err_t update(const PixelW* pixels)
+{
+    return defaultStrip().update(pixels);
+}
+
+neoled_err_t updateWithBrightness(const PixelW* pixels, uint8_t brightness)
+{
+    return defaultStrip().updateWithBrightness(pixels, brightness);
+}
+
+#if NEOLED_PIXEL16
+neoled_err_t update(const Pixel16* pixels)
+{
+    return defaultStrip().update(pixels);
+}
+
+neoled_err_t updateWithBrightness(const Pixel16* pixels, uint8_t brightness)
+{
+    return defaultStrip().updateWithBrightness(pixels, brightness);
+}
+#endif
+
+neoled_err_t updateRange(const Pixel* pixels, uint16_t count)
+{
+    return defaultStrip().updateRange(pixels, count);
+}
+
+#if NEOLED_ASYNC
+neoled_err_t updateAsync(const Pixel* pixels)
+{
+    return defaultStrip().updateAsync(pixels);
+}
+
+neoled_err_t updateAsync(const PixelW* pixels)
+{
+    return defaultStrip().updateAsync(pixels);
+}
+
+#if NEOLED_PIXEL16
+neoled_err_t updateAsync(const Pixel16* pixels)
+{
+    return defaultStrip().updateAsync(pixels);
+}
+#endif
+
+neoled_err_t waitForUpdate(uint32_t timeout_ms)
+{
+    return defaultStrip().waitForUpdate(timeout_ms);
+}
+
+void setUpdateCallback(neoled_update_cb_t callback, void* user_data)
+{
+    defaultStrip().setUpdateCallback(callback, user_data);
+}
+#endif
+
+Pixel* getPixels(void)
+{
+    return defaultStrip().getPixels();
+}
+
+PixelW* getPixelsW(void)
+{
+    return defaultStrip().getPixelsW();
+}
+
+neoled_err_t setPixel(uint16_t index, const Pixel& pixel)
+{
+    return defaultStrip().setPixel(index, pixel);
+}
+
+neoled_err_t setPixel(uint16_t index, const PixelW& pixel)
+{
+    return defaultStrip().setPixel(index, pixel);
+}
+
+neoled_err_t show(void)
+{
+    return defaultStrip().show();
+}
+
+#if NEOLED_ASYNC
+neoled_err_t showAsync(void)
+{
+    return defaultStrip().showAsync();
+}
+#endif
+
+neoled_err_t fill(const Pixel& colour)
+{
+    return defaultStrip().fill(colour);
+}
+
+neoled_err_t clear(void)
+{
+    return defaultStrip().clear();
+}
+
+neoled_err_t destroy(void)
+{
+    return defaultStrip().destroy();
+}
+
+bool isInitialized(void)
+{
+    return defaultStrip().isInitialized();
+}
+
+void setBrightness(uint8_t brightness)
+{
+    defaultStrip().setBrightness(brightness);
+}
+
+uint8_t getBrightness(void)
+{
+    return defaultStrip().getBrightness();
+}
+
+void setAutoPrefix(bool enable)
+{
+    defaultStrip().setAutoPrefix(enable);
+}
+
+bool getAutoPrefix(void)
+{
+    return defaultStrip().getAutoPrefix();
+}
+
+void setPowerLimit(uint16_t channel_ma, uint32_t limit_ma)
+{
+    defaultStrip().setPowerLimit(channel_ma, limit_ma);
+}
+
+uint32_t getPowerLimit(void)
+{
+    return defaultStrip().getPowerLimit();
+}
+
+uint32_t getEstimatedCurrent(void)
+{
+    return defaultStrip().getEstimatedCurrent();
+}
+
+neoled_err_t setColorCorrection(const neoled_color_correction_t* correction)
+{
+    return defaultStrip().setColorCorrection(correction);
+}
+
+void getColorCorrection(neoled_color_correction_t* correction)
+{
+    defaultStrip().getColorCorrection(correction);
+}
+
+neoled_err_t setStreaming(uint16_t chunk_leds)
+{
+    return defaultStrip().setStreaming(chunk_leds);
+}
+
+uint16_t getStreaming(void)
+{
+    return defaultStrip().getStreaming();
+}
+
+void getStreamStats(neoled_stream_stats_t* stats)
+{
+    defaultStrip().getStreamStats(stats);
+}
+
+neoled_err_t setEncodedFramebuffer(bool enable)
+{
+    return defaultStrip().setEncodedFramebuffer(enable);
+}
+
+bool getEncodedFramebuffer(void)
+{
+    return defaultStrip().getEncodedFramebuffer();
+}
+
+#if NEOLED_RENDER
+neoled_err_t startRender(int core)
+{
+    return defaultStrip().startRender(core);
+}
+
+neoled_err_t stopRender(void)
+{
+    return defaultStrip().stopRender();
+}
+
+Pixel* acquireFrame(void)
+{
+    return defaultStrip().acquireFrame();
+}
+
+PixelW* acquireFrameW(void)
+{
+    return defaultStrip().acquireFrameW();
+}
+
+neoled_err_t submitFrame(void)
+{
+    return defaultStrip().submitFrame();
+}
+
+uint32_t getDroppedFrames(void)
+{
+    return defaultStrip().getDroppedFrames();
+}
+#endif
+
+#if NEOLED_DITHER
+neoled_err_t setDithering(bool enable)
+{
+    return defaultStrip().setDithering(enable);
+}
+
+bool getDithering(void)
+{
+    return defaultStrip().getDithering();
+}
+
+neoled_err_t refresh(void)
+{
+    return defaultStrip().refresh();
+}
+
+#if NEOLED_RENDER
+neoled_err_t setDitherRefresh(uint16_t interval_ms)
+{
+    return defaultStrip().setDitherRefresh(interval_ms);
+}
+
+uint16_t getDitherRefresh(void)
+{
+    return defaultStrip().getDitherRefresh();
+}
+#endif
+#endif
+
+neoled_err_t getDmaInfo(neoled_dma_info_t* info)
+{
+    return defaultStrip().getDmaInfo(info);
+}
+
+uint16_t getSkippedPixels(void)
+{
+    return defaultStrip().getSkippedPixels();
+}
+
+void setGamma(float gamma)
+{
+    defaultStrip().setGamma(gamma);
+}
+
+float getGamma(void)
+{
+    return defaultStrip().getGamma();
+}
+
+// ============================================================================
+// SPI Encoding
+// ============================================================================
+
+size_t spiFrameBytes(uint16_t led_count)
+{
+    return (size_t)led_count * NEOLED_SPI_PIXEL_SIZE + NEOLED_SPI_RESET_BYTES;
+}
+
+void encodeSpi(const Pixel* pixels, uint16_t led_count, uint8_t* out)
+{
+    uint32_t table[256];
+    for (int value = 0; value < 256; value++) {
+        table[value] = byteToSpiWord((uint8_t)value);
+    }
+
+    ChannelTables tables;
+    for (int channel = 0; channel < 4; channel++) {
+        tables.encode[channel] = table;
+    }
+    for (uint16_t i = 0; i < led_count; i++) {
+        SpiFrame<GRBOrder>::store(tables, pixels[i], &out[i * NEOLED_SPI_PIXEL_SIZE]);
+    }
+    memset(&out[(size_t)led_count * NEOLED_SPI_PIXEL_SIZE], 0, NEOLED_SPI_RESET_BYTES);
+}
+
+// ============================================================================
+// Parallel Output
+// ============================================================================
+
+/**
+ * @brief Transpose an 8x8 bit matrix held in a 64-bit word
+ * @param x Row r in byte r, column c in bit c
+ * @return Matrix with bit c of byte r moved to bit r of byte c
+ */
+static inline uint64_t transpose8x8(uint64_t x)
+{
+    // Three delta swaps exchange 1x1, 2x2 and 4x4 blocks across the diagonal
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x ^= t ^ (t << 28);
+    return x;
+}
+
+/**
+ * @brief Emit the samples for one colour byte of 8 lanes
+ * @param bits Transposed lane bytes: byte n holds colour bit n of every lane
+ * @param out Output buffer (at least 8 * NEOLED_PARALLEL_SLOTS bytes)
+ * @return Pointer past the written samples
+ */
+static inline uint8_t* emitSamples8(uint64_t bits, uint8_t* out)
+{
+    for (int bit = 7; bit >= 0; bit--) {
+        out[0] = 0xFF;
+        out[1] = (uint8_t)(bits >> (bit * 8));
+        out[2] = 0x00;
+        out += NEOLED_PARALLEL_SLOTS;
+    }
+    return out;
+}
+
+/**
+ * @brief Emit the 16-bit samples for one colour byte of 16 lanes
+ * @param low Transposed bytes of lanes 0-7
+ * @param high Transposed bytes of lanes 8-15
+ * @param out Output buffer (at least 16 * NEOLED_PARALLEL_SLOTS bytes)
+ * @return Pointer past the written samples
+ */
+static inline uint8_t* emitSamples16(uint64_t low, uint64_t high, uint8_t* out)
+{
+    for (int bit = 7; bit >= 0; bit--) {
+        out[0] = 0xFF;
+        out[1] = 0xFF;
+        out[2] = (uint8_t)(low >> (bit * 8));
+        out[3] = (uint8_t)(high >> (bit * 8));
+        out[4] = 0x00;
+        out[5] = 0x00;
+        out += 2 * NEOLED_PARALLEL_SLOTS;
+    }
+    return out;
+}
+
+/**
+ * @brief Interleave lane pixel arrays into parallel samples
+ * @tparam Groups Number of 8-lane groups (1 or 2)
+ * @tparam Scaled Map colour values through levels (brightness and gamma)
+ * @param lanes Groups * 8 pixel arrays (nullptr = LEDs off)
+ * @param led_count LEDs per lane
+ * @param levels 256-entry colour level table, used when Scaled
+ * @param out Output buffer of parallelFrameBytes() bytes
+ */
+template <int Groups, bool Scaled>
+static void encodeParallelFrame(const Pixel* const* lanes, uint16_t led_count,
+                                const uint8_t* levels, uint8_t* out)
+{
+    static const Pixel off = {0, 0, 0};
+    const Pixel* src[Groups * 8];
+    size_t step[Groups * 8];
+
+    for (int l = 0; l < Groups * 8; l++) {
+        src[l] = lanes[l] != nullptr ? lanes[l] : &off;
+        step[l] = lanes[l] != nullptr ? 1 : 0;
+    }
+
+    for (uint16_t i = 0; i < led_count; i++) {
+        uint64_t green[Groups];
+        uint64_t red[Groups];
+        uint64_t blue[Groups];
+
+        // Gather one byte per lane into a word per channel, then transpose so
+        // each byte holds one colour bit of all eight lanes
+        for (int group = 0; group < Groups; group++) {
+            uint64_t g = 0;
+            uint64_t r = 0;
+            uint64_t b = 0;
+            for (int l = 0; l < 8; l++) {
+                const Pixel& p = *src[group * 8 + l];
+                g |= (uint64_t)(Scaled ? levels[p.green] : p.green) << (l * 8);
+                r |= (uint64_t)(Scaled ? levels[p.red] : p.red) << (l * 8);
+                b |= (uint64_t)(Scaled ? levels[p.blue] : p.blue) << (l * 8);
+            }
+            green[group] = transpose8x8(g);
+            red[group] = transpose8x8(r);
+            blue[group] = transpose8x8(b);
+        }
+
+        for (int l = 0; l < Groups * 8; l++) {
+            src[l] += step[l];
+        }
+
+        // Green first (WS2812 uses GRB format)
+        if (Groups == 1) {
+            out = emitSamples8(green[0], out);
+            out = emitSamples8(red[0], out);
+            out = emitSamples8(blue[0], out);
+        } else {
+            out = emitSamples16(green[0], green[Groups - 1], out);
+            out = emitSamples16(red[0], red[Groups - 1], out);
+            out = emitSamples16(blue[0], blue[Groups - 1], out);
+        }
+    }
+}
+
+size_t parallelFrameBytes(uint8_t lane_count, uint16_t led_count)
+{
+    if (lane_count != 8 && lane_count != 16) {
+        return 0;
+    }
+    // 24 colour bits per LED, NEOLED_PARALLEL_SLOTS samples per bit
+    return (size_t)led_count * 24 * NEOLED_PARALLEL_SLOTS * (lane_count / 8);
+}
+
+void encodeParallel(const Pixel* const* lanes, uint8_t lane_count, uint16_t led_count, uint8_t* out)
+{
+    if (lanes == nullptr || out == nullptr) {
+        return;
+    }
+
+    if (lane_count == 8) {
+        encodeParallelFrame<1, false>(lanes, led_count, nullptr, out);
+    } else if (lane_count == 16) {
+        encodeParallelFrame<2, false>(lanes, led_count, nullptr, out);
+    }
+}
+
+void encodeParallelReference(const Pixel* const* lanes, uint8_t lane_count, uint16_t led_count, uint8_t* out)
+{
+    if (lanes == nullptr || out == nullptr || (lane_count != 8 && lane_count != 16)) {
+        return;
+    }
+
+    size_t sample_bytes = lane_count / 8;
+    memset(out, 0, parallelFrameBytes(lane_count, led_count));
+
+    for (uint16_t i = 0; i < led_count; i++) {
+        for (int l = 0; l < lane_count; l++) {
+            Pixel p = lanes[l] != nullptr ? lanes[l][i] : COLOR_OFF;
+            uint8_t channels[3] = {p.green, p.red, p.blue};
+            uint8_t line = (uint8_t)(1 << (l % 8));
+
+            for (int c = 0; c < 3; c++) {
+                for (int bit = 0; bit < 8; bit++) {
+                    size_t sample = ((size_t)i * 24 + c * 8 + bit) * NEOLED_PARALLEL_SLOTS;
+                    uint8_t* first = &out[sample * sample_bytes + l / 8];
+
+                    first[0] |= line;  // High for every bit
+                    if (channels[c] & (0x80 >> bit)) {
+                        first[sample_bytes] |= line;  // Stays high for a one
+                    }
+                }
+            }
+        }
+    }
+}
+
+#if NEOLED_PARALLEL
+/**
+ * @brief Per-group driver state, owned by a ParallelStrip
+ */
+struct ParallelState {
+    uint8_t lane_count;
+    uint16_t led_count;
+    size_t frame_bytes;     // Samples for all LEDs plus reset samples
+    bool initialized;
+    int gpio_pins[16];
+
+    // Sample buffer, allocated once from DMA-capable memory; the bus DMA
+    // reads it in place, so it is only rewritten once frame_done is taken
+    uint8_t* buffer;
+    SemaphoreHandle_t frame_done;
+
+    // Colour levels: brightness and gamma folded into one byte table
+    uint8_t brightness;
+    float gamma;
+    uint8_t level_table[256];
+    bool levels_valid;
+    uint8_t levels_brightness;
+    float levels_gamma;
+
+    esp_lcd_i80_bus_handle_t bus;
+    esp_lcd_panel_io_handle_t io;
 };
 
+/**
+ * @brief Rebuild the level table if brightness or gamma changed
+ * @param p Parallel state
+ */
+static void prepareLevels(ParallelState* p)
+{
+    if (p->levels_valid && p->levels_brightness == p->brightness && p->levels_gamma == p->gamma) {
+        return;
+    }
+
+    for (int value = 0; value < 256; value++) {
+        uint8_t c = gammaValue((uint8_t)value, p->gamma);
+        p->level_table[value] = (uint8_t)((c * p->brightness) / 255);
+    }
+
+    p->levels_brightness = p->brightness;
+    p->levels_gamma = p->gamma;
+    p->levels_valid = true;
+}
+
+/**
+ * @brief Bus callback: the frame has left the sample buffer
+ */
+static bool IRAM_ATTR parallelFrameDone(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t* edata,
+                                        void* user_ctx)
+{
+    (void)io;
+    (void)edata;
+
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(static_cast<ParallelState*>(user_ctx)->frame_done, &woken);
+    return woken == pdTRUE;
+}
+
+/**
+ * @brief Encode all lanes into the sample buffer and queue it on the bus
+ * @param p Parallel state
+ * @param lanes lane_count pixel arrays (nullptr = LEDs off)
+ * @return NEOLED_OK on success, NEOLED_ERR_I2S if the bus rejected the frame
+ */
+static neoled_err_t showParallel(ParallelState* p, const Pixel* const* lanes)
+{
+    xSemaphoreTake(p->frame_done, portMAX_DELAY);
+
+    prepareLevels(p);
+    if (p->lane_count == 8) {
+        encodeParallelFrame<1, true>(lanes, p->led_count, p->level_table, p->buffer);
+    } else {
+        encodeParallelFrame<2, true>(lanes, p->led_count, p->level_table, p->buffer);
+    }
+
+    // No command phase: the reset samples already trail the frame in the buffer
+    esp_err_t ret = esp_lcd_panel_io_tx_color(p->io, -1, p->buffer, p->frame_bytes);
+    if (ret != ESP_OK) {
+        xSemaphoreGive(p->frame_done);
+        ESP_LOGE(TAG, "Parallel write failed: %s", esp_err_to_name(ret));
+        return NEOLED_ERR_I2S;
+    }
+
+    return NEOLED_OK;
+}
+
+/**
+ * @brief Release the parallel bus, reset its data GPIOs and delete frame_done
+ * @param p Parallel state
+ */
+static void deinitParallel(ParallelState* p)
+{
+    if (p->io != NULL) {
+        esp_lcd_panel_io_del(p->io);
+        p->io = NULL;
+    }
+    if (p->bus != NULL) {
+        esp_lcd_del_i80_bus(p->bus);
+        p->bus = NULL;
+
+        for (int l = 0; l < p->lane_count; l++) {
+            gpio_reset_pin(static_cast<gpio_num_t>(p->gpio_pins[l]));
+        }
+    }
+    if (p->frame_done != NULL) {
+        vSemaphoreDelete(p->frame_done);
+        p->frame_done = NULL;
+    }
+}
+
+ParallelStrip::ParallelStrip(uint8_t lane_count, uint16_t led_count)
+    : state(new (std::nothrow) ParallelState())
+{
+    if (state == nullptr) {
+        ESP_LOGE(TAG, "Failed to allocate parallel state");
+        return;
+    }
+
+    // Reset: NEOLED_RESET_US of all-low samples at NEOLED_PARALLEL_CLOCK_HZ
+    size_t reset_samples = (size_t)(((unsigned long long)NEOLED_RESET_US * NEOLED_PARALLEL_CLOCK_HZ
+                                     + 999999ULL) / 1000000ULL);
+
+    state->lane_count = lane_count;
+    state->led_count = led_count;
+    state->frame_bytes = parallelFrameBytes(lane_count, led_count) + reset_samples * (lane_count / 8);
+    state->brightness = 255;
+    state->gamma = 1.0f;
+    state->levels_gamma = 1.0f;
+}
+
+ParallelStrip::~ParallelStrip()
+{
+    if (state == nullptr) {
+        return;
+    }
+
+    destroy();
+    heap_caps_free(state->buffer);
+    delete state;
+}
+
+neoled_err_t ParallelStrip::init(const int* gpio_pins, int clock_pin)
+{
+    if (state == nullptr) {
+        return NEOLED_ERR_NO_MEM;
+    }
+
+    ParallelState* p = state;
+    if (p->initialized) {
+        ESP_LOGW(TAG, "Already initialized, call destroy() first");
+        return NEOLED_OK;
+    }
+
+    if ((p->lane_count != 8 && p->lane_count != 16) || p->led_count == 0 || gpio_pins == nullptr) {
+        ESP_LOGE(TAG, "Invalid parallel configuration (%u lanes, %u LEDs)", p->lane_count, p->led_count);
+        return NEOLED_ERR_PARAM;
+    }
+
+    if (p->buffer == NULL) {
+        p->buffer = (uint8_t*)heap_caps_calloc(1, p->frame_bytes, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+        if (p->buffer == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate %u bytes of DMA memory", (unsigned)p->frame_bytes);
+            return NEOLED_ERR_NO_MEM;
+        }
+    }
+
+    p->frame_done = xSemaphoreCreateBinary();
+    if (p->frame_done == NULL) {
+        return NEOLED_ERR_NO_MEM;
+    }
+    xSemaphoreGive(p->frame_done);
+
+    for (int l = 0; l < p->lane_count; l++) {
+        p->gpio_pins[l] = gpio_pins[l];
+    }
+
+    esp_lcd_i80_bus_config_t bus_config = {};
+    bus_config.dc_gpio_num = -1;
+    bus_config.wr_gpio_num = clock_pin;
+    bus_config.clk_src = LCD_CLK_SRC_DEFAULT;
+    for (int l = 0; l < p->lane_count; l++) {
+        bus_config.data_gpio_nums[l] = gpio_pins[l];
+    }
+    bus_config.bus_width = p->lane_count;
+    bus_config.max_transfer_bytes = p->frame_bytes;
+
+    esp_err_t ret = esp_lcd_new_i80_bus(&bus_config, &p->bus);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create parallel bus: %s", esp_err_to_name(ret));
+        deinitParallel(p);
+        return NEOLED_ERR_I2S;
+    }
+
+    esp_lcd_panel_io_i80_config_t io_config = {};
+    io_config.cs_gpio_num = -1;
+    io_config.pclk_hz = NEOLED_PARALLEL_CLOCK_HZ;
+    io_config.trans_queue_depth = 1;
+    io_config.on_color_trans_done = parallelFrameDone;
+    io_config.user_ctx = p;
+    io_config.lcd_cmd_bits = 8;
+    io_config.lcd_param_bits = 8;
+
+    ret = esp_lcd_new_panel_io_i80(p->bus, &io_config, &p->io);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create parallel IO: %s", esp_err_to_name(ret));
+        deinitParallel(p);
+        return NEOLED_ERR_I2S;
+    }
+
+    p->initialized = true;
+
+    ESP_LOGI(TAG, "Initialized parallel output: %u lanes, %u LEDs each", p->lane_count, p->led_count);
+
+    clear();
+
+    return NEOLED_OK;
+}
+
+neoled_err_t ParallelStrip::update(const Pixel* const* lanes)
+{
+    if (!isInitialized()) {
+        ESP_LOGE(TAG, "Not initialized");
+        return NEOLED_ERR_NOT_INIT;
+    }
+
+    if (lanes == nullptr) {
+        ESP_LOGE(TAG, "Null lane array");
+        return NEOLED_ERR_PARAM;
+    }
+
+    return showParallel(state, lanes);
+}
+
+neoled_err_t ParallelStrip::clear(void)
+{
+    if (!isInitialized()) {
+        return NEOLED_ERR_NOT_INIT;
+    }
+
+    const Pixel* off[16] = {};
+    return showParallel(state, off);
+}
+
+neoled_err_t ParallelStrip::destroy(void)
+{
+    if (!isInitialized()) {
+        return NEOLED_OK;
+    }
+
+    clear();
+
+    // Let the last frame leave the buffer before the bus goes away
+    ParallelState* p = state;
+    xSemaphoreTake(p->frame_done, portMAX_DELAY);
+    deinitParallel(p);
+
+    p->initialized = false;
+    ESP_LOGI(TAG, "Destroyed parallel output");
+
+    return NEOLED_OK;
+}
+
+bool ParallelStrip::isInitialized(void) const
+{
+    return state != nullptr && state->initialized;
+}
+
+uint8_t ParallelStrip::getLaneCount(void) const
+{
+    return state != nullptr ? state->lane_count : 0;
+}
+
+uint16_t ParallelStrip::getLedCount(void) const
+{
+    return state != nullptr ? state->led_count : 0;
+}
+
+void ParallelStrip::setBrightness(uint8_t brightness)
+{
+    if (state != nullptr) {
+        state->brightness = brightness;
+    }
+}
+
+uint8_t ParallelStrip::getBrightness(void) const
+{
+    return state != nullptr ? state->brightness : 0;
+}
+
+void ParallelStrip::setGamma(float gamma)
+{
+    if (state != nullptr) {
+        state->gamma = gamma;
+    }
+}
+
+float ParallelStrip::getGamma(void) const
+{
+    return state != nullptr ? state->gamma : 1.0f;
+}
+#endif
+
+// ============================================================================
+// Gamma Correction
+// ============================================================================
+
 Pixel gammaCorrect(const Pixel& pixel, float gamma)
 {
     Pixel result;
-    
-    if (gamma == 2.2f) {
-        // Use lookup table for common gamma value
-        result.red = gamma22_table[pixel.red];
-        result.green = gamma22_table[pixel.green];
-        result.blue = gamma22_table[pixel.blue];
+    result.red = gammaValue(pixel.red, gamma);
+    result.green = gammaValue(pixel.green, gamma);
+    result.blue = gammaValue(pixel.blue, gamma);
+    return result;
+}
+
+// ============================================================================
+// RGBW Conversion
+// ============================================================================
+
+/**
+ * @brief Approximate the colour of a white LED from its colour temperature
+ * @param kelvin Colour temperature (clamped to 2000-10000 K)
+ * @return Colour with its largest channel at 255 and no channel at 0
+ * @note Curve fit of the blackbody colour by Tanner Helland
+ */
+static Pixel kelvinToPixel(uint16_t kelvin)
+{
+    float t = (kelvin < 2000 ? 2000 : kelvin > 10000 ? 10000 : kelvin) / 100.0f;
+    float channels[3];  // red, green, blue
+    if (t <= 66.0f) {
+        channels[0] = 255.0f;
+        channels[1] = 99.4708025861f * logf(t) - 161.1195681661f;
+        channels[2] = 138.5177312231f * logf(t - 10.0f) - 305.0447927307f;
     } else {
-        // Calculate gamma for custom values
-        result.red = (uint8_t)(powf(pixel.red / 255.0f, gamma) * 255.0f + 0.5f);
-        result.green = (uint8_t)(powf(pixel.green / 255.0f, gamma) * 255.0f + 0.5f);
-        result.blue = (uint8_t)(powf(pixel.blue / 255.0f, gamma) * 255.0f + 0.5f);
+        channels[0] = 329.698727446f * powf(t - 60.0f, -0.1332047592f);
+        channels[1] = 288.1221695283f * powf(t - 60.0f, -0.0755148492f);
+        channels[2] = 255.0f;
+    }
+
+    uint8_t values[3];
+    for (int c = 0; c < 3; c++) {
+        float v = channels[c] < 1.0f ? 1.0f : channels[c] > 255.0f ? 255.0f : channels[c];
+        values[c] = (uint8_t)(v + 0.5f);
+    }
+    return makePixel(values[0], values[1], values[2]);
+}
+
+void rgbToRgbw(const Pixel* pixels, PixelW* out, uint16_t count, neoled_white_mode_t mode, uint16_t white_kelvin)
+{
+    if (pixels == nullptr || out == nullptr) {
+        return;
+    }
+
+    switch (mode) {
+        case NEOLED_WHITE_MIN:
+            for (uint16_t i = 0; i < count; i++) {
+                const Pixel& pixel = pixels[i];
+                uint8_t white = pixel.red < pixel.green ? pixel.red : pixel.green;
+                white = pixel.blue < white ? pixel.blue : white;
+                out[i].green = pixel.green - white;
+                out[i].red = pixel.red - white;
+                out[i].blue = pixel.blue - white;
+                out[i].white = white;
+            }
+            break;
+
+        case NEOLED_WHITE_TEMPERATURE: {
+            // The white LED lights all three colours at once, in proportion
+            // to its own colour: white takes the largest multiple of that
+            // colour the pixel contains and RGB keep the remainder. The
+            // per-channel scales are 16.16 fixed point; as the white point's
+            // largest channel is 255, the smallest scaled channel never
+            // exceeds 255.
+            Pixel point = kelvinToPixel(white_kelvin);
+            uint32_t scale_red = (255UL << 16) / point.red;
+            uint32_t scale_green = (255UL << 16) / point.green;
+            uint32_t scale_blue = (255UL << 16) / point.blue;
+            for (uint16_t i = 0; i < count; i++) {
+                const Pixel& pixel = pixels[i];
+                uint32_t red = (pixel.red * scale_red) >> 16;
+                uint32_t green = (pixel.green * scale_green) >> 16;
+                uint32_t blue = (pixel.blue * scale_blue) >> 16;
+                uint32_t white = red < green ? red : green;
+                white = blue < white ? blue : white;
+                out[i].green = (uint8_t)(pixel.green - (white * point.green + 127) / 255);
+                out[i].red = (uint8_t)(pixel.red - (white * point.red + 127) / 255);
+                out[i].blue = (uint8_t)(pixel.blue - (white * point.blue + 127) / 255);
+                out[i].white = (uint8_t)white;
+            }
+            break;
+        }
+
+        default:
+            for (uint16_t i = 0; i < count; i++) {
+                out[i].green = pixels[i].green;
+                out[i].red = pixels[i].red;
+                out[i].blue = pixels[i].blue;
+                out[i].white = 0;
+            }
+            break;
     }
-    
-    return result;
 }
 
 } // namespace NeoLED